@@ -0,0 +1,98 @@
+#include "terrain/Noise.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/*
+*	Cost per height sample of every noise variant and basis, batched (SampleHeights, SIMD when
+*	available) and one sample at a time (SampleHeight). Also reports whether both paths agree.
+*
+*	NoiseBenchmark [samples]
+*/
+namespace
+{
+	constexpr size_t g_defaultSampleCount = 1 << 18;
+	constexpr int g_repeatCount = 5; // Fastest run is reported
+
+	const char* const g_typeNames[] = {"fbm", "ridged", "billow", "domain warp"};
+	const char* const g_basisNames[] = {"value", "simplex"};
+
+	template <typename Function>
+	double NanosecondsPerSample(size_t sampleCount, Function&& function)
+	{
+		double best = 0.0;
+
+		for (int i = 0; i < g_repeatCount; ++i)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			function();
+			const auto end = std::chrono::steady_clock::now();
+
+			const double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(sampleCount);
+			best = (i == 0) ? nanoseconds : std::min(best, nanoseconds);
+		}
+
+		return best;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const size_t sampleCount = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : g_defaultSampleCount;
+
+	if (sampleCount == 0)
+	{
+		std::printf("Usage: NoiseBenchmark [samples]\n");
+		return 2;
+	}
+
+	// A 512 wide grid of samples, about one unit apart like a tile, far from the world origin
+	std::vector<float> localX(sampleCount);
+	std::vector<float> localZ(sampleCount);
+	std::vector<float> batched(sampleCount);
+	std::vector<float> single(sampleCount);
+
+	for (size_t i = 0; i < sampleCount; ++i)
+	{
+		localX[i] = static_cast<float>(i % 512) * 0.73f;
+		localZ[i] = static_cast<float>(i / 512) * 1.31f;
+	}
+
+	std::printf("%zu samples, octaves %d\n", sampleCount, src::noise::NoiseParams().m_octaves);
+	std::printf("%-12s %-8s %12s %12s %8s %s\n", "type", "basis", "batched ns", "single ns", "speedup", "match");
+
+	for (int basis = src::noise::BASIS_VALUE; basis <= src::noise::BASIS_SIMPLEX; ++basis)
+	{
+		for (int type = src::noise::NOISE_FBM; type <= src::noise::NOISE_DOMAIN_WARP; ++type)
+		{
+			src::noise::NoiseParams params;
+			params.m_type = static_cast<src::noise::ENoiseType>(type);
+			params.m_basis = static_cast<src::noise::ENoiseBasis>(basis);
+			params.m_seed = 1234;
+
+			const src::noise::NoiseOrigin origin = src::noise::MakeNoiseOrigin(123456.5, -98765.25, params);
+
+			const double batchedTime = NanosecondsPerSample(sampleCount, [&]
+			{
+				src::noise::SampleHeights(origin, localX.data(), localZ.data(), batched.data(), sampleCount, params);
+			});
+
+			const double singleTime = NanosecondsPerSample(sampleCount, [&]
+			{
+				for (size_t i = 0; i < sampleCount; ++i)
+					single[i] = src::noise::SampleHeight(origin, localX[i], localZ[i], params);
+			});
+
+			const bool isMatching = std::memcmp(batched.data(), single.data(), sampleCount * sizeof(float)) == 0;
+
+			std::printf("%-12s %-8s %12.1f %12.1f %7.2fx %s\n", g_typeNames[type], g_basisNames[basis], batchedTime, singleTime,
+						singleTime / batchedTime, isMatching ? "yes" : "no");
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,120 @@
+#include "terrain/HeightField.h"
+#include "terrain/Tile.h"
+#include "terrain/TileCodec.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+/*
+*	Compression ratio, largest error and decode speed of the tile codec for every noise variant
+*	and a few precisions, next to the time it takes to generate the same tiles.
+*
+*	TileCodecBenchmark [tiles]
+*/
+namespace
+{
+	constexpr unsigned int g_defaultTileCount = 64;
+	constexpr int g_repeatCount = 5; // Fastest run is reported
+	constexpr unsigned int g_precisions[] = {16, 14, 12, 10, 8};
+
+	const char* const g_typeNames[] = {"fbm", "ridged", "billow", "domain warp"};
+
+	using Clock = std::chrono::steady_clock;
+
+	double Seconds(Clock::time_point start, Clock::time_point end)
+	{
+		return std::chrono::duration<double>(end - start).count();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const unsigned int tileCount = (argc > 1) ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : g_defaultTileCount;
+
+	if (tileCount == 0)
+	{
+		std::printf("Usage: TileCodecBenchmark [tiles]\n");
+		return 2;
+	}
+
+	src::TileSettings settings;
+	const unsigned int tilesPerSide = static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<double>(tileCount))));
+
+	std::printf("%u LOD 0 tiles of %u x %u samples\n", tileCount, settings.m_resolution + 1, settings.m_resolution + 1);
+	std::printf("%-12s %4s %8s %10s %12s %12s %12s\n", "type", "bits", "ratio", "max error", "decode GB/s", "decode us", "generate us");
+
+	for (int type = src::noise::NOISE_FBM; type <= src::noise::NOISE_DOMAIN_WARP; ++type)
+	{
+		settings.m_noise.m_type = static_cast<src::noise::ENoiseType>(type);
+
+		std::vector<std::shared_ptr<src::HeightField>> tiles;
+		const Clock::time_point generateStart = Clock::now();
+
+		for (unsigned int i = 0; i < tileCount; ++i)
+		{
+			const int x = static_cast<int>(i % tilesPerSide);
+			const int z = static_cast<int>(i / tilesPerSide);
+
+			tiles.push_back(src::GenerateTile(src::TileKey::Make(settings, 0, x, z), settings));
+		}
+
+		const double generateTime = Seconds(generateStart, Clock::now()) / tileCount;
+
+		for (unsigned int precisionBits : g_precisions)
+		{
+			std::vector<std::vector<std::byte>> encoded(tileCount);
+			size_t rawBytes = 0;
+			size_t encodedBytes = 0;
+
+			for (unsigned int i = 0; i < tileCount; ++i)
+			{
+				std::vector<float> const& heights = tiles[i]->GetHeights();
+
+				src::codec::EncodeHeights(heights.data(), tiles[i]->GetSamplesPerSide(), encoded[i], precisionBits);
+				rawBytes += heights.size() * sizeof(float);
+				encodedBytes += encoded[i].size();
+			}
+
+			std::vector<float> decoded(tiles[0]->GetHeights().size());
+			double decodeTime = 0.0;
+			float maxError = 0.0f;
+
+			for (int repeat = 0; repeat < g_repeatCount; ++repeat)
+			{
+				const Clock::time_point decodeStart = Clock::now();
+
+				for (unsigned int i = 0; i < tileCount; ++i)
+				{
+					if (!src::codec::DecodeHeights(encoded[i].data(), encoded[i].size(), decoded.data(), tiles[i]->GetSamplesPerSide()))
+					{
+						std::printf("Failed to decode tile %u\n", i);
+						return 1;
+					}
+
+					// Only checked once, outside of the timed runs below
+					if (repeat == 0)
+					{
+						std::vector<float> const& heights = tiles[i]->GetHeights();
+
+						for (size_t sample = 0; sample < heights.size(); ++sample)
+							maxError = std::max(maxError, std::fabs(decoded[sample] - heights[sample]));
+					}
+				}
+
+				const double time = Seconds(decodeStart, Clock::now());
+				decodeTime = (repeat == 1 || decodeTime == 0.0) ? time : std::min(decodeTime, time);
+			}
+
+			std::printf("%-12s %4u %7.2fx %10.4f %12.2f %12.2f %12.2f\n", g_typeNames[type], precisionBits,
+						static_cast<double>(rawBytes) / static_cast<double>(encodedBytes), maxError,
+						static_cast<double>(rawBytes) / decodeTime * 1e-9, decodeTime / tileCount * 1e6, generateTime * 1e6);
+		}
+	}
+
+	return 0;
+}
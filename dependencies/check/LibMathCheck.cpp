@@ -0,0 +1,169 @@
+#include "LibMath/Matrix4Vector4Operation.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/*
+*	Runs fixed inputs through the Matrix4<float> operations with SIMD specializations and writes
+*	the raw results, or compares them with a file written by another build. The scalar build
+*	(LIBMATH_NO_SIMD) writes the reference, the SSE2 / AVX builds must match it byte for byte.
+*
+*	LibMathCheck write <file>
+*	LibMathCheck compare <file>
+*/
+namespace
+{
+	constexpr unsigned int g_matrixCount = 200000;
+	constexpr unsigned int g_pointCount = 1001; // Odd so the AVX path leaves a tail
+
+	using Matrix = math::Matrix4<float>;
+
+	class Inputs
+	{
+	public:
+		Inputs(void) = default;
+
+		// -100 - 100 with exact zeros of both signs mixed in
+		float Value(void)
+		{
+			const uint32_t bits = m_random();
+
+			if (bits % 17 == 0)
+				return (bits & 0x100) ? -0.0f : 0.0f;
+
+			return static_cast<float>(bits >> 8) * (200.0f / 16777216.0f) - 100.0f;
+		}
+
+		Matrix RandomMatrix(void)
+		{
+			Matrix result;
+
+			for (float (&column)[4] : result.m_matrix)
+			{
+				for (float& value : column)
+					value = Value();
+			}
+
+			return result;
+		}
+
+	private:
+		std::mt19937 m_random {7};
+	};
+
+	template <typename T>
+	void Append(std::vector<unsigned char>& bytes, T const& value)
+	{
+		unsigned char const* begin = reinterpret_cast<unsigned char const*>(&value);
+
+		bytes.insert(bytes.end(), begin, begin + sizeof(T));
+	}
+
+	std::vector<unsigned char> RunOperations(void)
+	{
+		Inputs inputs;
+		std::vector<unsigned char> bytes;
+
+		for (unsigned int i = 0; i < g_matrixCount; ++i)
+		{
+			// Every 50th matrix is singular (all zeros)
+			Matrix lhs = (i % 50 == 0) ? Matrix(inputs.Value() * 0.0f) : inputs.RandomMatrix();
+			const Matrix rhs = inputs.RandomMatrix();
+			const math::Vector4<float> vector(inputs.Value(), inputs.Value(), inputs.Value(), inputs.Value());
+
+			Matrix inverse = lhs;
+			inverse.Inverse();
+
+			Append(bytes, lhs * rhs);
+			Append(bytes, inverse);
+			Append(bytes, lhs * vector);
+		}
+
+		const Matrix transform = inputs.RandomMatrix();
+		std::vector<math::Vector3<float>> points(g_pointCount);
+		std::vector<math::Vector4<float>> transformed(g_pointCount);
+
+		for (math::Vector3<float>& point : points)
+			point = math::Vector3<float>(inputs.Value(), inputs.Value(), inputs.Value());
+
+		math::TransformPoints<float>(transform, points, transformed);
+
+		for (math::Vector4<float> const& point : transformed)
+			Append(bytes, point);
+
+		return bytes;
+	}
+
+	const char* PathName(void)
+	{
+#if defined(LIBMATH_AVX)
+		return "AVX";
+#elif defined(LIBMATH_SSE2)
+		return "SSE2";
+#else
+		return "scalar";
+#endif
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 3 || (std::strcmp(argv[1], "write") != 0 && std::strcmp(argv[1], "compare") != 0))
+	{
+		std::printf("Usage: LibMathCheck write|compare <file>\n");
+		return 2;
+	}
+
+	const std::vector<unsigned char> bytes = RunOperations();
+	const bool isWrite = std::strcmp(argv[1], "write") == 0;
+
+	FILE* file = std::fopen(argv[2], isWrite ? "wb" : "rb");
+
+	if (!file)
+	{
+		std::printf("Failed to open %s\n", argv[2]);
+		return 1;
+	}
+
+	if (isWrite)
+	{
+		const bool isWritten = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+		std::fclose(file);
+
+		if (!isWritten)
+		{
+			std::printf("Failed to write %s\n", argv[2]);
+			return 1;
+		}
+
+		std::printf("Wrote %zu bytes from the %s path\n", bytes.size(), PathName());
+		return 0;
+	}
+
+	std::vector<unsigned char> reference(bytes.size() + 1);
+	const size_t referenceSize = std::fread(reference.data(), 1, reference.size(), file);
+	std::fclose(file);
+
+	if (referenceSize != bytes.size())
+	{
+		std::printf("Failed to match %s, %zu bytes instead of %zu\n", argv[2], referenceSize, bytes.size());
+		return 1;
+	}
+
+	if (std::memcmp(reference.data(), bytes.data(), bytes.size()) != 0)
+	{
+		size_t offset = 0;
+
+		while (reference[offset] == bytes[offset])
+			++offset;
+
+		std::printf("Failed to match %s, the %s path differs at byte %zu\n", argv[2], PathName(), offset);
+		return 1;
+	}
+
+	std::printf("The %s path matches %s\n", PathName(), argv[2]);
+	return 0;
+}
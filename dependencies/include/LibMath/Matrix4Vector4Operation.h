@@ -1,24 +1,112 @@
 #pragma once
 
 #include "VariableType.hpp"
+#include "Simd.h"
+#include "vector/Vector3.h"
 #include "vector/Vector4.h"
 #include "matrix/Matrix4.h"
 
+#include <cstddef>
+#include <span>
+
 namespace math
 {
 	template<math::math_type::NumericType T>
 	Vector4<T> operator*(Matrix4<T> const& mat4, Vector4<T> const& vec4)
 	{
-		LibMath::Vector4<T> result;
+		Vector4<T> result;
 
-		// Multiply & add x,y,z,w element of vector with corresponding matrix row
-		for (int i = 0; i < 3; ++i)
+		// Matrices are column major, each element of the vector scales the corresponding column
+		for (int i = 0; i < 4; ++i)
 		{
-			result[i] = mat4.m_matrix[i][0] * vec4[0] + mat4.m_matrix[i][1] * vec4[1] + mat4.m_matrix[i][2] * vec4[2] + mat4.m_matrix[i][3] * vec4[3];
+			result[i] = mat4.m_matrix[0][i] * vec4[0] + mat4.m_matrix[1][i] * vec4[1] + mat4.m_matrix[2][i] * vec4[2] + mat4.m_matrix[3][i] * vec4[3];
 		}
 
 		return result;
 	}
+
+	/*
+	*	Transforms every point (w = 1) into result, which needs at least as many elements as points.
+	*	Matches transforming Vector4(x, y, z, 1) one at a time
+	*/
+	template<math::math_type::NumericType T>
+	void TransformPoints(Matrix4<T> const& mat4, std::span<Vector3<T> const> points, std::span<Vector4<T>> result)
+	{
+		_ASSERT(result.size() >= points.size());
+
+		const T one = static_cast<T>(1.0f);
+
+		for (std::size_t i = 0; i < points.size(); ++i)
+		{
+			result[i] = mat4 * Vector4<T>(points[i][0], points[i][1], points[i][2], one);
+		}
+	}
+
+#ifdef LIBMATH_SSE2
+	template<>
+	inline Vector4<float> operator*(Matrix4<float> const& mat4, Vector4<float> const& vec4)
+	{
+		__m128 column = _mm_mul_ps(_mm_loadu_ps(mat4.m_matrix[0]), _mm_set1_ps(vec4[0]));
+
+		column = _mm_add_ps(column, _mm_mul_ps(_mm_loadu_ps(mat4.m_matrix[1]), _mm_set1_ps(vec4[1])));
+		column = _mm_add_ps(column, _mm_mul_ps(_mm_loadu_ps(mat4.m_matrix[2]), _mm_set1_ps(vec4[2])));
+		column = _mm_add_ps(column, _mm_mul_ps(_mm_loadu_ps(mat4.m_matrix[3]), _mm_set1_ps(vec4[3])));
+
+		Vector4<float> result;
+		_mm_storeu_ps(&result[0], column);
+
+		return result;
+	}
+
+	template<>
+	inline void TransformPoints(Matrix4<float> const& mat4, std::span<Vector3<float> const> points, std::span<Vector4<float>> result)
+	{
+		_ASSERT(result.size() >= points.size());
+
+		// The last column is added as is, multiplying it by w = 1 wouldn't change a bit
+		const __m128 column0 = _mm_loadu_ps(mat4.m_matrix[0]);
+		const __m128 column1 = _mm_loadu_ps(mat4.m_matrix[1]);
+		const __m128 column2 = _mm_loadu_ps(mat4.m_matrix[2]);
+		const __m128 column3 = _mm_loadu_ps(mat4.m_matrix[3]);
+
+		std::size_t i = 0;
+
+#ifdef LIBMATH_AVX
+		// Two points per iteration, one in each half
+		const __m256 columnPair0 = _mm256_insertf128_ps(_mm256_castps128_ps256(column0), column0, 1);
+		const __m256 columnPair1 = _mm256_insertf128_ps(_mm256_castps128_ps256(column1), column1, 1);
+		const __m256 columnPair2 = _mm256_insertf128_ps(_mm256_castps128_ps256(column2), column2, 1);
+		const __m256 columnPair3 = _mm256_insertf128_ps(_mm256_castps128_ps256(column3), column3, 1);
+
+		for (; i + 2 <= points.size(); i += 2)
+		{
+			Vector3<float> const& first = points[i];
+			Vector3<float> const& second = points[i + 1];
+
+			__m256 columns = _mm256_mul_ps(columnPair0, _mm256_set_ps(second[0], second[0], second[0], second[0], first[0], first[0], first[0], first[0]));
+
+			columns = _mm256_add_ps(columns, _mm256_mul_ps(columnPair1, _mm256_set_ps(second[1], second[1], second[1], second[1], first[1], first[1], first[1], first[1])));
+			columns = _mm256_add_ps(columns, _mm256_mul_ps(columnPair2, _mm256_set_ps(second[2], second[2], second[2], second[2], first[2], first[2], first[2], first[2])));
+			columns = _mm256_add_ps(columns, columnPair3);
+
+			_mm256_storeu_ps(&result[i][0], columns);
+		}
+#endif
+
+		for (; i < points.size(); ++i)
+		{
+			Vector3<float> const& point = points[i];
+
+			__m128 column = _mm_mul_ps(column0, _mm_set1_ps(point[0]));
+
+			column = _mm_add_ps(column, _mm_mul_ps(column1, _mm_set1_ps(point[1])));
+			column = _mm_add_ps(column, _mm_mul_ps(column2, _mm_set1_ps(point[2])));
+			column = _mm_add_ps(column, column3);
+
+			_mm_storeu_ps(&result[i][0], column);
+		}
+	}
+#endif
 }
 
-namespace LibMath = math;
\ No newline at end of file
+namespace LibMath = math;
@@ -0,0 +1,21 @@
+#pragma once
+
+/*
+*	Instruction sets available to the current translation unit
+*
+*	SSE2 is part of every x64 target, AVX is only used when the compiler targets it (/arch:AVX, -mavx).
+*	The float specializations built on them perform the same operations in the same order as the
+*	generic templates, results are bit identical as long as the compiler doesn't contract multiply
+*	and add into FMA (MSVC /fp:precise, -ffp-contract=off)
+*
+*	Defining LIBMATH_NO_SIMD keeps every type on the generic templates, LibMathCheck compares both builds
+*/
+#if !defined(LIBMATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define LIBMATH_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+#if defined(LIBMATH_SSE2) && defined(__AVX__)
+	#define LIBMATH_AVX 1
+	#include <immintrin.h>
+#endif
@@ -2,6 +2,7 @@
 
 #include "../VariableType.hpp"
 #include "../Macros.h"
+#include "../Simd.h"
 #include "../Arithmetic.h"
 #include "../angle/Radians.h"
 #include "../vector/Vector3.h"
@@ -550,6 +551,129 @@ namespace math
 	{
 		return !(*this == matrix);
 	}
+
+#ifdef LIBMATH_SSE2
+	/*
+	*	Float specializations
+	*
+	*	Every lane performs the generic template's operations in the same order (products
+	*	accumulated from zero, minors through Matrix3::Determinant's expression, adjugate
+	*	divided by the determinant) so results are bit identical to the scalar path
+	*/
+
+	template<>
+	inline Matrix4<float> Matrix4<float>::operator*(Matrix4<float> const& matrix)
+	{
+		Matrix4<float> result;
+
+		const __m128 column0 = _mm_loadu_ps(m_matrix[0]);
+		const __m128 column1 = _mm_loadu_ps(m_matrix[1]);
+		const __m128 column2 = _mm_loadu_ps(m_matrix[2]);
+		const __m128 column3 = _mm_loadu_ps(m_matrix[3]);
+
+#ifdef LIBMATH_AVX
+		// Two result columns per iteration
+		const __m256 columnPair0 = _mm256_insertf128_ps(_mm256_castps128_ps256(column0), column0, 1);
+		const __m256 columnPair1 = _mm256_insertf128_ps(_mm256_castps128_ps256(column1), column1, 1);
+		const __m256 columnPair2 = _mm256_insertf128_ps(_mm256_castps128_ps256(column2), column2, 1);
+		const __m256 columnPair3 = _mm256_insertf128_ps(_mm256_castps128_ps256(column3), column3, 1);
+
+		for (int j = 0; j < 4; j += 2)
+		{
+			const float* lhs = matrix.m_matrix[j];
+			const float* rhs = matrix.m_matrix[j + 1];
+
+			__m256 columns = _mm256_setzero_ps();
+
+			columns = _mm256_add_ps(columns, _mm256_mul_ps(columnPair0, _mm256_set_ps(rhs[0], rhs[0], rhs[0], rhs[0], lhs[0], lhs[0], lhs[0], lhs[0])));
+			columns = _mm256_add_ps(columns, _mm256_mul_ps(columnPair1, _mm256_set_ps(rhs[1], rhs[1], rhs[1], rhs[1], lhs[1], lhs[1], lhs[1], lhs[1])));
+			columns = _mm256_add_ps(columns, _mm256_mul_ps(columnPair2, _mm256_set_ps(rhs[2], rhs[2], rhs[2], rhs[2], lhs[2], lhs[2], lhs[2], lhs[2])));
+			columns = _mm256_add_ps(columns, _mm256_mul_ps(columnPair3, _mm256_set_ps(rhs[3], rhs[3], rhs[3], rhs[3], lhs[3], lhs[3], lhs[3], lhs[3])));
+
+			_mm256_storeu_ps(result.m_matrix[j], columns);
+		}
+#else
+		for (int j = 0; j < 4; ++j)
+		{
+			// Starting from zero like the generic loop keeps the sign of zero results identical
+			__m128 column = _mm_setzero_ps();
+
+			column = _mm_add_ps(column, _mm_mul_ps(column0, _mm_set1_ps(matrix.m_matrix[j][0])));
+			column = _mm_add_ps(column, _mm_mul_ps(column1, _mm_set1_ps(matrix.m_matrix[j][1])));
+			column = _mm_add_ps(column, _mm_mul_ps(column2, _mm_set1_ps(matrix.m_matrix[j][2])));
+			column = _mm_add_ps(column, _mm_mul_ps(column3, _mm_set1_ps(matrix.m_matrix[j][3])));
+
+			_mm_storeu_ps(result.m_matrix[j], column);
+		}
+#endif
+
+		return result;
+	}
+
+	template<>
+	inline Matrix4<float>& Matrix4<float>::Inverse(void)
+	{
+		/*
+		*	Lane j of minors[i] is the determinant of the 3x3 matrix without row i and column j.
+		*	Each row is shuffled so lane j holds the three values left once column j is removed
+		*/
+		__m128 rows[4][3];
+
+		for (int i = 0; i < 4; ++i)
+		{
+			const __m128 row = _mm_loadu_ps(m_matrix[i]);
+
+			rows[i][0] = _mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 1));
+			rows[i][1] = _mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 2, 2));
+			rows[i][2] = _mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 3, 3, 3));
+		}
+
+		__m128 minors[4];
+
+		for (int i = 0; i < 4; ++i)
+		{
+			// Remaining rows, in order
+			const __m128* row0 = rows[(i < 1) ? 1 : 0];
+			const __m128* row1 = rows[(i < 2) ? 2 : 1];
+			const __m128* row2 = rows[(i < 3) ? 3 : 2];
+
+			// a(ei - fh) - b(di - gf) + c(dh - eg)
+			const __m128 a = _mm_mul_ps(row0[0], _mm_sub_ps(_mm_mul_ps(row1[1], row2[2]), _mm_mul_ps(row1[2], row2[1])));
+			const __m128 b = _mm_mul_ps(row0[1], _mm_sub_ps(_mm_mul_ps(row1[0], row2[2]), _mm_mul_ps(row2[0], row1[2])));
+			const __m128 c = _mm_mul_ps(row0[2], _mm_sub_ps(_mm_mul_ps(row1[0], row2[1]), _mm_mul_ps(row1[1], row2[0])));
+
+			minors[i] = _mm_add_ps(_mm_sub_ps(a, b), c);
+		}
+
+		// Expansion along the first row, accumulated in the generic path's order
+		float firstRowMinors[4];
+		_mm_storeu_ps(firstRowMinors, minors[0]);
+
+		float determinant = 0.0f;
+
+		for (int i = 0; i < 4; ++i)
+			determinant += (i % 2 == 0) ? m_matrix[0][i] * firstRowMinors[i] : -m_matrix[0][i] * firstRowMinors[i];
+
+		if (determinant == 0)
+			return *this;
+
+		// Adjugate: transposed minors with the cofactor signs, lane i of column j needs -1 when i + j is odd
+		_MM_TRANSPOSE4_PS(minors[0], minors[1], minors[2], minors[3]);
+
+		const __m128 evenSigns = _mm_castsi128_ps(_mm_set_epi32(static_cast<int>(0x80000000), 0, static_cast<int>(0x80000000), 0));
+		const __m128 oddSigns = _mm_castsi128_ps(_mm_set_epi32(0, static_cast<int>(0x80000000), 0, static_cast<int>(0x80000000)));
+		const __m128 denominator = _mm_set1_ps(determinant);
+
+		for (int j = 0; j < 4; ++j)
+		{
+			const __m128 cofactors = _mm_xor_ps(minors[j], (j % 2 == 0) ? evenSigns : oddSigns);
+
+			_mm_storeu_ps(m_matrix[j], _mm_div_ps(cofactors, denominator));
+		}
+
+		return *this;
+	}
+#endif
 }
 
 namespace LibMath = math;
\ No newline at end of file
@@ -6,13 +6,26 @@
 
 #include <iostream>
 
-src::Camera::Camera(math::Vector3<float> position, float speed)
+namespace
+{
+	inline math::Vector3<double> ToDouble(math::Vector3<float> const& vec3) noexcept
+	{
+		return math::Vector3<double>(vec3[0], vec3[1], vec3[2]);
+	}
+
+	// Exact comparison, Vector3::operator== tolerates differences a moving camera can produce
+	inline bool IsSame(math::Vector3<double> const& lhs, math::Vector3<double> const& rhs) noexcept
+	{
+		return lhs[0] == rhs[0] && lhs[1] == rhs[1] && lhs[2] == rhs[2];
+	}
+}
+
+src::Camera::Camera(math::Vector3<double> position, float speed)
 	: m_position(position), m_speed(speed), m_angularSpeed(5.0f),
 	m_yaw(0.0f), m_pitch(0.0f)
 {
-	m_up = math::Vector3<float>::Up();
-	m_forward = -math::Vector3<float>::Forward();
-	m_right = (m_forward.Cross(m_up)).Normalize();
+	// Same basis as the first MouseMotion call would give
+	UpdateOrientation();
 }
 
 math::Matrix4<float> src::Camera::GetPerspectiveMatrix(float _near, float _far, float fovDeg, float aspect) const noexcept
@@ -33,11 +46,15 @@ math::Matrix4<float> src::Camera::GetPerspectiveMatrix(float _near, float _far,
 	return math::Matrix4<float>(perspectiveValues);
 }
 
-math::Matrix4<float> src::Camera::GetViewMatrix(void)
+math::Matrix4<float> src::Camera::GetViewMatrix(math::Vector3<double> const& origin)
 {
+	// Camera position in render space, small as long as the origin follows the camera
+	const math::Vector3<double> offset = m_position - origin;
+	const math::Vector3<float> position(static_cast<float>(offset[0]), static_cast<float>(offset[1]), static_cast<float>(offset[2]));
+
 	// Camera forward direction
-	math::Vector3<float> center = m_position + m_forward;
-	math::Vector3<float> forward = (center - m_position).Normalize();
+	math::Vector3<float> forward = m_forward;
+	forward.Normalize();
 	m_right = (forward.Cross(m_up)).Normalize();
 	math::Vector3<float> up = m_right.Cross(forward);
 
@@ -46,39 +63,91 @@ math::Matrix4<float> src::Camera::GetViewMatrix(void)
 		m_right[0], up[0], -forward[0], 0.0f,
 		m_right[1], up[1], -forward[1], 0.0f,
 		m_right[2], up[2], -forward[2], 0.0f,
-		-(m_right.Dot(m_position)), -(up.Dot(m_position)), forward.Dot(m_position), 1.0f
+		-(m_right.Dot(position)), -(up.Dot(position)), forward.Dot(position), 1.0f
 	};
 
 	return math::Matrix4<float>(viewValues);
 }
 
-math::Vector3<float> src::Camera::GetPosition(void) const noexcept
+math::Vector3<double> const& src::Camera::GetPosition(void) const noexcept
 {
 	return m_position;
 }
 
-math::Vector3<float>& src::Camera::GetPosition(void)
+math::Vector3<float> const& src::Camera::GetForward(void) const noexcept
 {
-	return m_position;
+	return m_forward;
+}
+
+void src::Camera::SetPosition(math::Vector3<double> const& position) noexcept
+{
+	m_isViewDirty |= !IsSame(position, m_position);
+	m_position = position;
+}
+
+void src::Camera::SetProjection(float _near, float _far, float fovDeg, float aspect) noexcept
+{
+	if (_near == m_near && _far == m_far && fovDeg == m_fovDeg && aspect == m_aspect)
+		return;
+
+	m_near = _near;
+	m_far = _far;
+	m_fovDeg = fovDeg;
+	m_aspect = aspect;
+	m_isProjectionDirty = true;
+}
+
+void src::Camera::SetOrigin(math::Vector3<double> const& origin) noexcept
+{
+	m_isViewDirty |= !IsSame(origin, m_origin);
+	m_origin = origin;
+}
+
+src::CameraState const& src::Camera::GetState(void)
+{
+	if (!m_isViewDirty && !m_isProjectionDirty)
+		return m_state;
+
+	if (m_isViewDirty)
+		m_state.m_view = GetViewMatrix(m_origin);
+
+	if (m_isProjectionDirty)
+		m_state.m_projection = GetPerspectiveMatrix(m_near, m_far, m_fovDeg, m_aspect);
+
+	m_state.m_viewProjection = m_state.m_projection * m_state.m_view;
+	m_state.m_inverseViewProjection = m_state.m_viewProjection;
+	m_state.m_inverseViewProjection.Inverse();
+	m_state.m_frustum = Frustum(m_state.m_viewProjection);
+	++m_state.m_version;
+
+	m_isViewDirty = false;
+	m_isProjectionDirty = false;
+
+	return m_state;
 }
 
 void src::Camera::CameraInput(GLFWwindow* windowPtr, float deltaTime)
 {
-	// Keyboard inputs
+	// Keyboard inputs, accumulated in double precision
+	const float step = m_speed * deltaTime;
+	const math::Vector3<double> previousPosition = m_position;
+
 	if (glfwGetKey(windowPtr, GLFW_KEY_W) == GLFW_PRESS)
-		m_position += m_forward * m_speed * deltaTime;
+		m_position += ToDouble(m_forward * step);
 	else if (glfwGetKey(windowPtr, GLFW_KEY_S) == GLFW_PRESS)
-		m_position += -m_forward * m_speed * deltaTime;
+		m_position -= ToDouble(m_forward * step);
 
 	if (glfwGetKey(windowPtr, GLFW_KEY_A) == GLFW_PRESS)
-		m_position += -m_right * m_speed * deltaTime;
+		m_position -= ToDouble(m_right * step);
 	else if (glfwGetKey(windowPtr, GLFW_KEY_D) == GLFW_PRESS)
-		m_position += m_right * m_speed * deltaTime;
+		m_position += ToDouble(m_right * step);
 
 	if (glfwGetKey(windowPtr, GLFW_KEY_Q) == GLFW_PRESS)
-		m_position -= math::Vector3<float>::Up() * m_speed * deltaTime;
+		m_position -= ToDouble(math::Vector3<float>::Up() * step);
 	else if (glfwGetKey(windowPtr, GLFW_KEY_E) == GLFW_PRESS)
-		m_position += math::Vector3<float>::Up() * m_speed * deltaTime;
+		m_position += ToDouble(math::Vector3<float>::Up() * step);
+
+	m_isViewDirty |= !IsSame(previousPosition, m_position);
 }
 
 void src::Camera::MouseMotion(math::Vector2<float> const& cursorPos, float deltaTime)
@@ -98,6 +167,9 @@ void src::Camera::MouseMotion(math::Vector2<float> const& cursorPos, float delta
 	m_lastCursorPos = cursorPos;
 
 	// Update yaw & pitch
+	const float previousYaw = m_yaw;
+	const float previousPitch = m_pitch;
+
 	m_yaw += deltaPos[0] * m_angularSpeed;
 	m_pitch -= deltaPos[1] * m_angularSpeed;
 
@@ -105,6 +177,16 @@ void src::Camera::MouseMotion(math::Vector2<float> const& cursorPos, float delta
 	m_yaw = fmodf(m_yaw, 360.0f);
 	m_pitch = fmodf(m_pitch, 360.0f);
 
+	// The basis only depends on the angles, a still mouse keeps it (and the cached view)
+	if (m_yaw == previousYaw && m_pitch == previousPitch)
+		return;
+
+	UpdateOrientation();
+	m_isViewDirty = true;
+}
+
+void src::Camera::UpdateOrientation(void) noexcept
+{
 	// Convert degree to radian
 	const float yawRad = m_yaw * DEG2RAD;
 	const float pitchRad = m_pitch * DEG2RAD;
@@ -1,31 +1,79 @@
 #pragma once
 
+#include "camera/Frustum.h"
+
 #include "LibMath/Vector/Vector2.h"
 #include "LibMath/Vector/Vector3.h"
 #include "LibMath/Matrix/Matrix4.h"
 
+#include <cstdint>
+
 #define GLFW_INCLUDE_NONE
 #include <glfw/glfw3.h>
 
 namespace src
 {
+	// Everything derived from the camera for one render space, recomputed only when an input changes
+	struct CameraState
+	{
+		math::Matrix4<float>	m_view;
+		math::Matrix4<float>	m_projection;
+		math::Matrix4<float>	m_viewProjection;
+		math::Matrix4<float>	m_inverseViewProjection;
+		Frustum					m_frustum; // Render space, same as the matrices
+
+		// Incremented every time the matrices change, equal versions mean identical state
+		uint64_t				m_version = 0;
+	};
+
 	class Camera
 	{
 	public:
 		Camera(void) = default;
-		Camera(math::Vector3<float> position, float speed);
+		Camera(math::Vector3<double> position, float speed);
 		~Camera(void) = default;
 
 		math::Matrix4<float>	GetPerspectiveMatrix(float near, float far, float fovDeg, float aspect) const noexcept;
-		math::Matrix4<float>	GetViewMatrix(void);
-		math::Vector3<float>	GetPosition(void) const noexcept;
-		math::Vector3<float>&	GetPosition(void);
+
+		/*
+		*	View of a render space whose origin is the world position 'origin' (floating origin).
+		*	The camera offset is computed in double precision before being narrowed, so vertices
+		*	given relative to a nearby origin stay precise however far the camera is from 0.
+		*/
+		math::Matrix4<float>	GetViewMatrix(math::Vector3<double> const& origin);
+
+		// World space, double precision
+		math::Vector3<double> const&	GetPosition(void) const noexcept;
+		void							SetPosition(math::Vector3<double> const& position) noexcept;
+
+		// Normalized view direction
+		math::Vector3<float> const&		GetForward(void) const noexcept;
+
+		// Only flag the state dirty when a value differs, cheap to call every frame
+		void					SetProjection(float near, float far, float fovDeg, float aspect) noexcept;
+		void					SetOrigin(math::Vector3<double> const& origin) noexcept;
+
+		// Recomputes the parts of the state whose inputs changed since the last call
+		CameraState const&		GetState(void);
+
 		void					CameraInput(GLFWwindow* windowPtr, float deltaTime);
 		void					MouseMotion(math::Vector2<float> const& cursorPos, float deltaTime);
 
 	private:
+		void					UpdateOrientation(void) noexcept;
+
+		// Cached state and its inputs
+		CameraState				m_state;
+		math::Vector3<double>	m_origin;
+		float					m_near = 0.01f;
+		float					m_far = 100.0f;
+		float					m_fovDeg = 60.0f;
+		float					m_aspect = 1.0f;
+		bool					m_isViewDirty = true;
+		bool					m_isProjectionDirty = true;
+
 		// View matrix
-		math::Vector3<float>	m_position;
+		math::Vector3<double>	m_position;
 		math::Vector3<float>	m_up;
 		math::Vector3<float>	m_right;
 		math::Vector3<float>	m_forward;
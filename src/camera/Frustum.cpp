@@ -0,0 +1,233 @@
+#include "camera/Frustum.h"
+#include "utility/Simd.h"
+
+#include <cmath>
+#include <cstddef>
+
+namespace
+{
+	// Signed distance to the plane scaled by the normal's length, shared by every path so results match
+	inline float PlaneDistance(math::Vector4<float> const& plane, float x, float y, float z) noexcept
+	{
+		return plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+	}
+}
+
+src::Frustum::Frustum(void)
+{
+	// Null planes, every distance is 0 so nothing is rejected
+	for (unsigned int i = 0; i < s_planeCount; ++i)
+	{
+		m_planes[i] = math::Vector4<float>::Zero();
+		UpdateCornerOffsets(i);
+	}
+}
+
+src::Frustum::Frustum(math::Matrix4<float> const& viewProjection)
+{
+	// Column major, row r of the matrix is m_matrix[0..3][r]
+	auto row = [&viewProjection](int r)
+	{
+		return math::Vector4<float>(viewProjection.m_matrix[0][r], viewProjection.m_matrix[1][r],
+									viewProjection.m_matrix[2][r], viewProjection.m_matrix[3][r]);
+	};
+
+	const math::Vector4<float> w = row(3);
+
+	// Left, right, bottom, top, near, far
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		const math::Vector4<float> r = row(axis);
+
+		m_planes[2 * axis] = w + r;
+		m_planes[2 * axis + 1] = w - r;
+	}
+
+	// Unit normals so the sphere test compares distances with the radius
+	for (math::Vector4<float>& plane : m_planes)
+	{
+		const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+
+		if (length > 0.0f)
+			plane /= length;
+	}
+
+	for (unsigned int i = 0; i < s_planeCount; ++i)
+		UpdateCornerOffsets(i);
+}
+
+bool src::Frustum::TestBox(math::Vector3<float> const& boundsMin, math::Vector3<float> const& boundsMax) const noexcept
+{
+	for (math::Vector4<float> const& plane : m_planes)
+	{
+		// Corner furthest along the plane normal
+		const float x = (plane[0] >= 0.0f) ? boundsMax[0] : boundsMin[0];
+		const float y = (plane[1] >= 0.0f) ? boundsMax[1] : boundsMin[1];
+		const float z = (plane[2] >= 0.0f) ? boundsMax[2] : boundsMin[2];
+
+		if (PlaneDistance(plane, x, y, z) < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+bool src::Frustum::TestSphere(math::Vector3<float> const& center, float radius) const noexcept
+{
+	for (math::Vector4<float> const& plane : m_planes)
+	{
+		if (PlaneDistance(plane, center[0], center[1], center[2]) < -radius)
+			return false;
+	}
+
+	return true;
+}
+
+uint32_t src::Frustum::TestBoxes(BoxBatch const& boxes) const noexcept
+{
+	// Bounds arrays holding each plane's furthest corner, chosen once per frustum
+	auto corner = [&boxes, this](unsigned int plane, unsigned int axis)
+	{
+		return reinterpret_cast<float const*>(reinterpret_cast<char const*>(&boxes) + m_cornerOffsets[plane][axis]);
+	};
+
+#if defined(SRC_SIMD_AVX)
+	__m256 outside = _mm256_setzero_ps();
+
+	for (unsigned int i = 0; i < s_planeCount; ++i)
+	{
+		math::Vector4<float> const& plane = m_planes[i];
+
+		__m256 distance = _mm256_mul_ps(_mm256_set1_ps(plane[0]), _mm256_load_ps(corner(i, 0)));
+		distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane[1]), _mm256_load_ps(corner(i, 1))));
+		distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane[2]), _mm256_load_ps(corner(i, 2))));
+		distance = _mm256_add_ps(distance, _mm256_set1_ps(plane[3]));
+
+		outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ));
+	}
+
+	return ~static_cast<uint32_t>(_mm256_movemask_ps(outside)) & 0xFFu;
+#elif defined(SRC_SIMD_SSE2)
+	// Lanes 0 - 3 and 4 - 7
+	__m128 outsideLow = _mm_setzero_ps();
+	__m128 outsideHigh = _mm_setzero_ps();
+
+	for (unsigned int i = 0; i < s_planeCount; ++i)
+	{
+		const __m128 normalX = _mm_set1_ps(m_planes[i][0]);
+		const __m128 normalY = _mm_set1_ps(m_planes[i][1]);
+		const __m128 normalZ = _mm_set1_ps(m_planes[i][2]);
+		const __m128 distance = _mm_set1_ps(m_planes[i][3]);
+
+		__m128 low = _mm_mul_ps(normalX, _mm_load_ps(corner(i, 0)));
+		__m128 high = _mm_mul_ps(normalX, _mm_load_ps(corner(i, 0) + 4));
+		low = _mm_add_ps(low, _mm_mul_ps(normalY, _mm_load_ps(corner(i, 1))));
+		high = _mm_add_ps(high, _mm_mul_ps(normalY, _mm_load_ps(corner(i, 1) + 4)));
+		low = _mm_add_ps(low, _mm_mul_ps(normalZ, _mm_load_ps(corner(i, 2))));
+		high = _mm_add_ps(high, _mm_mul_ps(normalZ, _mm_load_ps(corner(i, 2) + 4)));
+		low = _mm_add_ps(low, distance);
+		high = _mm_add_ps(high, distance);
+
+		outsideLow = _mm_or_ps(outsideLow, _mm_cmplt_ps(low, _mm_setzero_ps()));
+		outsideHigh = _mm_or_ps(outsideHigh, _mm_cmplt_ps(high, _mm_setzero_ps()));
+	}
+
+	const uint32_t outside = static_cast<uint32_t>(_mm_movemask_ps(outsideLow)) | (static_cast<uint32_t>(_mm_movemask_ps(outsideHigh)) << 4);
+
+	return ~outside & 0xFFu;
+#else
+	uint32_t visible = 0;
+
+	for (unsigned int lane = 0; lane < BoxBatch::s_size; ++lane)
+	{
+		bool isInside = true;
+
+		for (unsigned int i = 0; i < s_planeCount && isInside; ++i)
+			isInside = PlaneDistance(m_planes[i], corner(i, 0)[lane], corner(i, 1)[lane], corner(i, 2)[lane]) >= 0.0f;
+
+		visible |= static_cast<uint32_t>(isInside) << lane;
+	}
+
+	return visible;
+#endif
+}
+
+uint32_t src::Frustum::TestSpheres(SphereBatch const& spheres) const noexcept
+{
+#if defined(SRC_SIMD_AVX)
+	const __m256 centerX = _mm256_load_ps(spheres.m_centerX);
+	const __m256 centerY = _mm256_load_ps(spheres.m_centerY);
+	const __m256 centerZ = _mm256_load_ps(spheres.m_centerZ);
+	const __m256 negativeRadius = _mm256_xor_ps(_mm256_load_ps(spheres.m_radius), _mm256_set1_ps(-0.0f));
+	__m256 outside = _mm256_setzero_ps();
+
+	for (math::Vector4<float> const& plane : m_planes)
+	{
+		__m256 distance = _mm256_mul_ps(_mm256_set1_ps(plane[0]), centerX);
+		distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane[1]), centerY));
+		distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane[2]), centerZ));
+		distance = _mm256_add_ps(distance, _mm256_set1_ps(plane[3]));
+
+		outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, negativeRadius, _CMP_LT_OQ));
+	}
+
+	return ~static_cast<uint32_t>(_mm256_movemask_ps(outside)) & 0xFFu;
+#elif defined(SRC_SIMD_SSE2)
+	// Lanes 0 - 3 and 4 - 7
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 negativeRadiusLow = _mm_xor_ps(_mm_load_ps(spheres.m_radius), signMask);
+	const __m128 negativeRadiusHigh = _mm_xor_ps(_mm_load_ps(spheres.m_radius + 4), signMask);
+	__m128 outsideLow = _mm_setzero_ps();
+	__m128 outsideHigh = _mm_setzero_ps();
+
+	for (math::Vector4<float> const& plane : m_planes)
+	{
+		const __m128 normalX = _mm_set1_ps(plane[0]);
+		const __m128 normalY = _mm_set1_ps(plane[1]);
+		const __m128 normalZ = _mm_set1_ps(plane[2]);
+		const __m128 distance = _mm_set1_ps(plane[3]);
+
+		__m128 low = _mm_mul_ps(normalX, _mm_load_ps(spheres.m_centerX));
+		__m128 high = _mm_mul_ps(normalX, _mm_load_ps(spheres.m_centerX + 4));
+		low = _mm_add_ps(low, _mm_mul_ps(normalY, _mm_load_ps(spheres.m_centerY)));
+		high = _mm_add_ps(high, _mm_mul_ps(normalY, _mm_load_ps(spheres.m_centerY + 4)));
+		low = _mm_add_ps(low, _mm_mul_ps(normalZ, _mm_load_ps(spheres.m_centerZ)));
+		high = _mm_add_ps(high, _mm_mul_ps(normalZ, _mm_load_ps(spheres.m_centerZ + 4)));
+		low = _mm_add_ps(low, distance);
+		high = _mm_add_ps(high, distance);
+
+		outsideLow = _mm_or_ps(outsideLow, _mm_cmplt_ps(low, negativeRadiusLow));
+		outsideHigh = _mm_or_ps(outsideHigh, _mm_cmplt_ps(high, negativeRadiusHigh));
+	}
+
+	const uint32_t outside = static_cast<uint32_t>(_mm_movemask_ps(outsideLow)) | (static_cast<uint32_t>(_mm_movemask_ps(outsideHigh)) << 4);
+
+	return ~outside & 0xFFu;
+#else
+	uint32_t visible = 0;
+
+	for (unsigned int lane = 0; lane < SphereBatch::s_size; ++lane)
+	{
+		const math::Vector3<float> center(spheres.m_centerX[lane], spheres.m_centerY[lane], spheres.m_centerZ[lane]);
+
+		visible |= static_cast<uint32_t>(TestSphere(center, spheres.m_radius[lane])) << lane;
+	}
+
+	return visible;
+#endif
+}
+
+void src::Frustum::UpdateCornerOffsets(unsigned int index) noexcept
+{
+	math::Vector4<float> const& plane = m_planes[index];
+
+	// Same choice as TestBox
+	m_cornerOffsets[index][0] = (plane[0] >= 0.0f) ? offsetof(BoxBatch, m_maxX) : offsetof(BoxBatch, m_minX);
+	m_cornerOffsets[index][1] = (plane[1] >= 0.0f) ? offsetof(BoxBatch, m_maxY) : offsetof(BoxBatch, m_minY);
+	m_cornerOffsets[index][2] = (plane[2] >= 0.0f) ? offsetof(BoxBatch, m_maxZ) : offsetof(BoxBatch, m_minZ);
+}
+
+math::Vector4<float> const& src::Frustum::GetPlane(unsigned int index) const noexcept
+{
+	return m_planes[index];
+}
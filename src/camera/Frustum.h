@@ -0,0 +1,68 @@
+#pragma once
+
+#include "LibMath/matrix/Matrix4.h"
+#include "LibMath/vector/Vector3.h"
+#include "LibMath/vector/Vector4.h"
+
+#include <cstdint>
+
+namespace src
+{
+	// Eight axis aligned boxes, one per lane (structure of arrays)
+	struct BoxBatch
+	{
+		static constexpr unsigned int s_size = 8;
+
+		alignas(32) float m_minX[s_size];
+		alignas(32) float m_minY[s_size];
+		alignas(32) float m_minZ[s_size];
+		alignas(32) float m_maxX[s_size];
+		alignas(32) float m_maxY[s_size];
+		alignas(32) float m_maxZ[s_size];
+	};
+
+	// Eight spheres, one per lane (structure of arrays)
+	struct SphereBatch
+	{
+		static constexpr unsigned int s_size = 8;
+
+		alignas(32) float m_centerX[s_size];
+		alignas(32) float m_centerY[s_size];
+		alignas(32) float m_centerZ[s_size];
+		alignas(32) float m_radius[s_size];
+	};
+
+	/*
+	*	Six planes extracted from the rows of a view projection matrix (Gribb / Hartmann), the same
+	*	test as ChunkCull.comp. Planes are normalized and point inside, a volume is rejected only
+	*	when it lies entirely behind one plane, so tests are conservative: boxes crossing two planes
+	*	near a frustum corner may be kept although they are outside.
+	*
+	*	Positions are in the space the matrix transforms from, a default frustum contains everything.
+	*/
+	class Frustum
+	{
+	public:
+		static constexpr unsigned int s_planeCount = 6;
+
+		Frustum(void);
+		explicit Frustum(math::Matrix4<float> const& viewProjection);
+		~Frustum(void) = default;
+
+		bool TestBox(math::Vector3<float> const& boundsMin, math::Vector3<float> const& boundsMax) const noexcept;
+		bool TestSphere(math::Vector3<float> const& center, float radius) const noexcept;
+
+		// Bit i is set when box / sphere i may be visible, 8 per call (AVX, SSE2 or scalar)
+		uint32_t TestBoxes(BoxBatch const& boxes) const noexcept;
+		uint32_t TestSpheres(SphereBatch const& spheres) const noexcept;
+
+		// Normal in xyz, distance in w: a point p is inside when dot(xyz, p) + w >= 0
+		math::Vector4<float> const& GetPlane(unsigned int index) const noexcept;
+
+	private:
+		void UpdateCornerOffsets(unsigned int index) noexcept;
+
+		math::Vector4<float>	m_planes[s_planeCount];
+		uint32_t				m_cornerOffsets[s_planeCount][3]; // Byte offset in BoxBatch of the bounds array holding the furthest corner
+	};
+}
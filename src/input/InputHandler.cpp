@@ -32,15 +32,11 @@ void src::InputHandler::UpdateKeyState(void)
 		GetInstance()->m_scrollUpdated = EScrollState::NO_INPUT;
 	}
 
-	for (auto& input : GetInstance()->m_inputMap)
-	{
-		input.second.m_prevState = input.second.m_state;
-
-		if (input.second.m_state == EInputState::STATE_PRESSED)
-			input.second.m_state = EInputState::STATE_HELD;
-		else if (input.second.m_state == EInputState::STATE_RELEASED)
-			input.second.m_state = EInputState::STATE_UP;
-	}
+	// Constant time whatever was pressed, a few words copied. Latched presses count as down
+	// so a key pressed and released in the same poll isn't lost
+	GetInstance()->m_prevDown = GetInstance()->m_down;
+	GetInstance()->m_down = GetInstance()->m_liveDown | GetInstance()->m_livePressed;
+	GetInstance()->m_livePressed.reset();
 
 	GetInstance()->m_mousePosDelta = GetInstance()->m_mousePos - GetInstance()->m_prevMousePos;
 	GetInstance()->m_prevMousePos = GetInstance()->m_mousePos;
@@ -53,23 +49,24 @@ void src::InputHandler::SetCursorMode(ECursorMode mode)
 
 bool src::InputHandler::IsInputPressed(int keyCode)
 {
-	return GetInstance()->m_inputMap[keyCode].m_prevState == EInputState::STATE_PRESSED;
+	return IsValidCode(keyCode) && GetInstance()->m_down[keyCode] && !GetInstance()->m_prevDown[keyCode];
 }
 
 bool src::InputHandler::IsInputHeld(int keyCode)
 {
-	return GetInstance()->m_inputMap[keyCode].m_state == EInputState::STATE_HELD;
+	// Callbacks run while polling events, after UpdateKeyState, so a key down in this frame's
+	// snapshot has already been down for one update, like the former pressed -> held transition
+	return IsValidCode(keyCode) && GetInstance()->m_down[keyCode];
 }
 
 bool src::InputHandler::IsInputDown(int keyCode)
 {
-	return GetInstance()->m_inputMap[keyCode].m_state == EInputState::STATE_PRESSED ||
-		GetInstance()->m_inputMap[keyCode].m_state == EInputState::STATE_HELD;
+	return IsValidCode(keyCode) && GetInstance()->m_down[keyCode];
 }
 
 bool src::InputHandler::IsInputReleased(int keyCode)
 {
-	return GetInstance()->m_inputMap[keyCode].m_prevState == EInputState::STATE_RELEASED;
+	return IsValidCode(keyCode) && !GetInstance()->m_down[keyCode] && GetInstance()->m_prevDown[keyCode];
 }
 
 void src::InputHandler::KeyboardCallback(int key, int scanCode, int action, int mod)
@@ -77,34 +74,28 @@ void src::InputHandler::KeyboardCallback(int key, int scanCode, int action, int
 	(void) scanCode;
 	(void) mod;
 
-	InputState input;
-	input.m_state = static_cast<EInputState>(action);
+	// Unknown keys are reported as -1
+	if (!IsValidCode(key))
+		return;
 
-	if (input.m_state == EInputState::STATE_PRESSED)
-		input.m_prevState = EInputState::STATE_UP;
-	else if (input.m_state == EInputState::STATE_HELD || input.m_state == EInputState::STATE_RELEASED)
-		input.m_prevState = EInputState::STATE_HELD;
-	else if (input.m_state == EInputState::STATE_UP)
-		input.m_prevState = EInputState::STATE_UP;
+	// Pressed and repeated (held) keys are down
+	GetInstance()->m_liveDown[key] = static_cast<EInputState>(action) != EInputState::STATE_RELEASED;
 
-	GetInstance()->m_inputMap[key] = input;
+	if (static_cast<EInputState>(action) == EInputState::STATE_PRESSED)
+		GetInstance()->m_livePressed[key] = true;
 }
 
 void src::InputHandler::MouseButtonCallback(int button, int action, int mods)
 {
 	(void) mods;
 
-	InputState input;
-	input.m_state = static_cast<EInputState>(action);
+	if (!IsValidCode(button))
+		return;
 
-	if (input.m_state == EInputState::STATE_PRESSED)
-		input.m_prevState = EInputState::STATE_UP;
-	else if (input.m_state == EInputState::STATE_HELD || input.m_state == EInputState::STATE_RELEASED)
-		input.m_prevState = EInputState::STATE_HELD;
-	else if (input.m_state == EInputState::STATE_UP)
-		input.m_prevState = EInputState::STATE_UP;
+	GetInstance()->m_liveDown[button] = static_cast<EInputState>(action) != EInputState::STATE_RELEASED;
 
-	GetInstance()->m_inputMap[button] = input;
+	if (static_cast<EInputState>(action) == EInputState::STATE_PRESSED)
+		GetInstance()->m_livePressed[button] = true;
 }
 
 void src::InputHandler::MouseScrollCallback(double xOffset, double yOffset)
@@ -124,6 +115,11 @@ src::InputHandler::InputHandler(void)
 {
 }
 
+bool src::InputHandler::IsValidCode(int code) noexcept
+{
+	return code >= 0 && code < s_inputCount;
+}
+
 src::InputHandler* src::InputHandler::GetInstance(void)
 {
 	if (!m_instance)
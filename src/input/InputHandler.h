@@ -4,7 +4,7 @@
 
 #include <LibMath/VariableType.hpp>
 #include <LibMath/vector/Vector2.h>
-#include <unordered_map>
+#include <bitset>
 
 namespace src
 {
@@ -33,16 +33,19 @@ namespace src
 		SECOND_FRAME, // Reset scroll delta
 	};
 
-	struct InputState
-	{
-		EInputState m_state = EInputState::STATE_UP;
-		EInputState m_prevState = EInputState::STATE_UP;
-
-	};
-
+	/*
+	*	Keys and mouse buttons share one code range: GLFW key codes start at 32, buttons are 0 - 7.
+	*	Callbacks only flip a bit of the live state, UpdateKeyState snapshots it once per frame next
+	*	to the previous snapshot, so queries compare two bits of the same code and never allocate.
+	*	Presses are also latched until the next snapshot, a tap released within one poll still
+	*	gives a pressed frame followed by a released frame.
+	*/
 	class InputHandler
 	{
 		public:
+			// Highest GLFW key code (menu) + 1, codes outside [0, s_inputCount) are ignored
+			static constexpr int s_inputCount = KEY_MENU + 1;
+
 			static int StartUp(void);
 			static int ShutDown(void);
 			static void UpdateKeyState(void);
@@ -75,7 +78,12 @@ namespace src
 
 			static InputHandler* m_instance;
 
-			std::unordered_map<int, InputState> m_inputMap;
+			static bool IsValidCode(int code) noexcept;
+
+			std::bitset<s_inputCount> m_liveDown; // Written by the callbacks
+			std::bitset<s_inputCount> m_livePressed; // Presses since the last snapshot, written by the callbacks
+			std::bitset<s_inputCount> m_down; // Snapshot of the current frame
+			std::bitset<s_inputCount> m_prevDown; // Snapshot of the previous frame
 			math::Vector2<double> m_mousePos;
 			math::Vector2<double> m_prevMousePos;
 			math::Vector2<double> m_mousePosDelta;
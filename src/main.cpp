@@ -5,16 +5,45 @@
 #include "camera/Camera.h"
 #include "resource/ResourceManager.h"
 #include "resource/shader/Shader.h"
-#include "utility/Buffer.h"
-#include "rendering/mesh/Grid.h"
+#include "utility/BufferAllocator.h"
+#include "utility/RingBuffer.h"
+#include "rendering/DepthPyramid.h"
+#include "rendering/FrameConstants.h"
+#include "rendering/TerrainRenderer.h"
+#include "rendering/TileTextures.h"
+#include "terrain/TileArchive.h"
+#include "terrain/TileCache.h"
+#include "terrain/TileStreamer.h"
+#include "utility/Ray.h"
+#include "utility/ThreadPool.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 
 #define FILL 0
-#define SUB_DIVISIONS 16 // Modify amount of sub divisions (min = 1)
+#define SHADER_HOT_RELOAD 1 // Relink the terrain shader when one of its sources is saved
+#define SUB_DIVISIONS 16 // Maximum amount of sub divisions per patch edge (power of two, min = 1), levels are powers of two
+#define TESSELLATION_SCALE 48.0f // Sub divisions of an edge as long as its distance to the camera
+#define TERRAIN_CHUNKS 5 // Chunks per side, every chunk is one indirect draw command
+#define CHUNK_PATCHES 2 // Patches per chunk side
+#define GPU_CULLING 1 // Frustum cull chunks in a compute pass which writes the indirect commands
+#define OCCLUSION_CULLING 1 // Skip tessellating patches hidden in the previous frame's depth pyramid
+#define NOISE_TYPE src::noise::NOISE_FBM // Terrain style shared by the shader and the CPU tiles
+#define NOISE_BASIS src::noise::BASIS_VALUE // Value or simplex noise octaves
+#define TILE_CACHE_BUDGET (32 * 1024 * 1024) // Bytes of generated CPU tiles kept around
+#define TILE_ARCHIVE_PATH "terrain.tiles" // Optional baked tiles, preferred over generation
+#define TILE_THREADS 1 // Workers generating CPU tiles off the render thread
+#define TILE_RADIUS 2 // Tiles streamed around the camera in each direction
+#define TILE_HEIGHTS 1 // Draw the resident CPU tiles (cached, baked, eroded) instead of evaluating the noise per vertex
+#define PICK_DISTANCE 200.0f // Range of the terrain picked with the left mouse button
+#define MESH_ARENA_SIZE (16 * 1024 * 1024) // Bytes per shared vertex / index buffer
+#define FRAME_STREAM_SIZE (1024 * 1024) // Bytes of per-frame data (constants, instances) per frame in flight
+#define UPLOAD_BUDGET_MS 2.0f // Render thread time spent creating GL objects of asynchronously loaded resources
 
 int main()
 {
@@ -25,14 +54,67 @@ int main()
 
 	src::Camera camera({0.0f, 0.0f, 0.0f}, 15.0f);
 
-	auto gridShader = src::ResourceManager::LoadShader(
+	// CPU tiles around the camera used for picking and drawing, revisited areas are served from the cache
+	src::TileSettings tileSettings;
+	tileSettings.m_noise.m_type = NOISE_TYPE;
+	tileSettings.m_noise.m_basis = NOISE_BASIS;
+
+	// Declared before the streamer, which waits for its tiles in flight when destroyed
+	src::ThreadPool tilePool(TILE_THREADS);
+	src::TileArchive tileArchive;
+	src::TileCache tileCache(TILE_CACHE_BUDGET);
+	src::TileStreamer tileStreamer(tileCache, tileSettings, TILE_RADIUS, TILE_THREADS);
+	tileStreamer.SetThreadPool(&tilePool);
+
+	if (std::filesystem::exists(TILE_ARCHIVE_PATH) && tileArchive.Open(TILE_ARCHIVE_PATH))
+		tileStreamer.SetArchive(&tileArchive);
+
+	auto gridShaderHandle = src::ResourceManager::LoadShader(
 		"TerrainShader", 
 		"shaders/Terrain.vert", 
 		"shaders/Terrain.frag",
 		"shaders/Terrain.tesc",
 		"shaders/Terrain.tese"
 	);
-	src::Grid grid({0.0f, 0.0f}, {100.0f, 100.0f}, 10);
+	src::ShaderProgram* gridShader = src::ResourceManager::Get(gridShaderHandle);
+
+#if SHADER_HOT_RELOAD == 1
+	gridShader->EnableHotReload();
+#endif
+
+	src::BufferAllocator meshAllocator(MESH_ARENA_SIZE);
+	src::RingBuffer frameStream(FRAME_STREAM_SIZE);
+	src::TerrainRenderer terrain(meshAllocator, {0.0f, 0.0f}, {100.0f, 100.0f}, TERRAIN_CHUNKS, CHUNK_PATCHES, tileSettings.m_noise);
+
+	src::TileTextures tileTextures(tileStreamer, TILE_RADIUS);
+
+	src::ShaderProgram* cullShader = nullptr;
+
+#if GPU_CULLING == 1
+	auto cullShaderHandle = src::ResourceManager::LoadComputeShader("ChunkCullShader", "shaders/ChunkCull.comp");
+	cullShader = src::ResourceManager::Get(cullShaderHandle);
+
+	terrain.SetCullShader(cullShader);
+#endif
+
+	src::DepthPyramid depthPyramid;
+	src::ShaderProgram* depthPyramidShader = nullptr;
+
+#if OCCLUSION_CULLING == 1
+	auto depthPyramidShaderHandle = src::ResourceManager::LoadComputeShader("DepthPyramidShader", "shaders/DepthPyramid.comp");
+	depthPyramidShader = src::ResourceManager::Get(depthPyramidShaderHandle);
+
+	depthPyramid.SetBuildShader(depthPyramidShader);
+	terrain.SetDepthPyramid(&depthPyramid);
+#endif
+
+#if SHADER_HOT_RELOAD == 1
+	if (cullShader)
+		cullShader->EnableHotReload();
+
+	if (depthPyramidShader)
+		depthPyramidShader->EnableHotReload();
+#endif
 
 #if FILL == 0
 	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
@@ -44,30 +126,118 @@ int main()
 
 	src::InputHandler::SetCursorMode(src::ECursorMode::MODE_DISABLED);
 
+	math::Matrix4<float> previousViewProjection;
+	math::Vector3<double> previousOrigin;
+
 	while (!window.ShouldWindowClose())
 	{
 		// Update systems
 		src::g_time.Update();
 		src::InputHandler::UpdateKeyState();
+		src::ResourceManager::ProcessUploads(UPLOAD_BUDGET_MS);
+
+#if SHADER_HOT_RELOAD == 1
+		gridShader->ReloadIfChanged();
+
+		if (cullShader)
+			cullShader->ReloadIfChanged();
+
+		if (depthPyramidShader)
+			depthPyramidShader->ReloadIfChanged();
+#endif
 
 		// Camera update
 		camera.CameraInput(window, src::g_time.GetDeltaTime());
 		camera.MouseMotion(src::InputHandler::GetCursorPosition<float>(), src::g_time.GetDeltaTime());
-		auto viewMatrix = camera.GetViewMatrix();
-		auto projMatrix = camera.GetPerspectiveMatrix(0.01f, 250.0f, 60.0f, window.GetAspectRatio());
-		
+
+		// Floating origin, everything given to the GPU is relative to the terrain grid which follows the camera
+		terrain.Recenter(camera.GetPosition());
+		math::Vector3<double> const& origin = terrain.GetOrigin();
+		math::Vector3<double> const cameraOffset = camera.GetPosition() - origin;
+
+		// Matrices and frustum are only rebuilt when the camera, the origin or the window changed
+		camera.SetOrigin(origin);
+		camera.SetProjection(0.01f, 250.0f, 60.0f, window.GetAspectRatio());
+		src::CameraState const& cameraState = camera.GetState();
+
+		// Express last frame's matrix relative to the current origin
+		math::Vector3<double> const originShift = origin - previousOrigin;
+		previousViewProjection = previousViewProjection * math::Matrix4<float>::Identity().Translate(
+			static_cast<float>(originShift[0]), static_cast<float>(originShift[1]), static_cast<float>(originShift[2]));
+
+		// Tiles are in world space, the ones entering the area are uploaded for the terrain shader
+		tileStreamer.Update(camera.GetPosition());
+
+#if TILE_HEIGHTS == 1
+		tileTextures.Update(camera.GetPosition());
+#endif
+
+		// Pick the terrain under the cross hair (the cursor is hidden)
+		if (src::InputHandler::IsInputPressed(MOUSE_BUTTON_LEFT))
+		{
+			math::Vector3<double> const& position = camera.GetPosition();
+			const src::Ray ray(math::Vector3<float>(static_cast<float>(position[0]), static_cast<float>(position[1]),
+									static_cast<float>(position[2])), camera.GetForward());
+			src::RayHit hit;
+
+			if (tileStreamer.Raycast(ray, PICK_DISTANCE, hit))
+				std::printf("Picked terrain at (%.2f, %.2f, %.2f), %.2f units away\n", hit.m_position[0], hit.m_position[1], hit.m_position[2], hit.m_distance);
+		}
+
 		src::Clear();
 
-		// Set uniform values
-		gridShader->Use();
-		gridShader->Set("view", &viewMatrix);
-		gridShader->Set("projection", &projMatrix);
+		// Per frame constants, written straight into mapped memory the GPU is no longer reading
+		frameStream.BeginFrame();
 
-		gridShader->Set("divCount", SUB_DIVISIONS);
+		src::FrameConstants frameConstants;
+		frameConstants.m_view = cameraState.m_view;
+		frameConstants.m_projection = cameraState.m_projection;
+		frameConstants.m_previousViewProjection = previousViewProjection;
+
+		frameConstants.m_cameraPosition = math::Vector4<float>(
+			static_cast<float>(cameraOffset[0]), static_cast<float>(cameraOffset[1]), static_cast<float>(cameraOffset[2]), 1.0f);
+		frameConstants.m_noiseOrigin = src::noise::MakeNoiseOrigin(origin[0], origin[2], tileSettings.m_noise);
 
-		// draw grid
-		grid.Update();
+		src::RingAllocation constants = frameStream.Allocate(sizeof(src::FrameConstants), frameStream.GetUniformAlignment());
 
+		if (constants.IsValid())
+		{
+			std::memcpy(constants.m_data, &frameConstants, sizeof(src::FrameConstants));
+			glBindBufferRange(GL_UNIFORM_BUFFER, src::FrameConstants::s_binding, constants.m_buffer, constants.m_offset, constants.m_size);
+		}
+
+		terrain.Cull(cameraState.m_frustum, cameraState.m_version);
+
+		// Set uniform values
+		gridShader->Use();
+		gridShader->Set("divCount", SUB_DIVISIONS);
+		gridShader->Set("tessellationScale", TESSELLATION_SCALE);
+
+		// Every noise parameter, the chunk bounds and the CPU tiles are built from the same ones
+		gridShader->Set("seed", tileSettings.m_noise.m_seed);
+		gridShader->Set("scale", tileSettings.m_noise.m_scale);
+		gridShader->Set("heightScale", tileSettings.m_noise.m_heightScale);
+		gridShader->Set("persistence", tileSettings.m_noise.m_persistence);
+		gridShader->Set("lacunarity", tileSettings.m_noise.m_lacunarity);
+		gridShader->Set("octaves", tileSettings.m_noise.m_octaves);
+		gridShader->Set("noiseBasis", static_cast<int>(tileSettings.m_noise.m_basis));
+		gridShader->Set("noiseType", static_cast<int>(tileSettings.m_noise.m_type));
+		gridShader->Set("ridgeGain", tileSettings.m_noise.m_ridgeGain);
+		gridShader->Set("warpStrength", tileSettings.m_noise.m_warpStrength);
+		gridShader->Set("occlusionCulling", depthPyramid.IsValid());
+
+		// Without TILE_HEIGHTS no layer is ever set and every vertex samples the noise
+		tileTextures.Bind(*gridShader, origin);
+
+		// Draw every terrain chunk with one call
+		terrain.Draw(frameStream);
+
+		// Depth is tested against next frame, the back buffer is undefined once swapped
+		depthPyramid.Build(window.GetWidth<int>(), window.GetHeight<int>());
+		previousViewProjection = cameraState.m_viewProjection;
+		previousOrigin = origin;
+
+		frameStream.EndFrame();
 		window.Update();
 	}
 
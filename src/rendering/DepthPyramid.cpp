@@ -0,0 +1,108 @@
+#include "rendering/DepthPyramid.h"
+#include "resource/shader/Shader.h"
+
+#include "glad/glad.h"
+
+#include <algorithm>
+
+src::DepthPyramid::DepthPyramid(void)
+	: m_buildShader(nullptr), m_depthTexture(0), m_pyramidTexture(0), m_levelCount(0), m_width(0), m_height(0), m_isValid(false)
+{
+}
+
+src::DepthPyramid::~DepthPyramid(void)
+{
+	DeleteTextures();
+}
+
+void src::DepthPyramid::Build(int width, int height)
+{
+	if (!m_buildShader || width <= 0 || height <= 0)
+		return;
+
+	if (width != m_width || height != m_height)
+		Resize(width, height);
+
+	// Depth textures copy from the read framebuffer's depth buffer, whatever its format
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glCopyTextureSubImage2D(m_depthTexture, 0, 0, 0, 0, 0, width, height);
+
+	m_buildShader->Use();
+
+	for (unsigned int level = 0; level < m_levelCount; ++level)
+	{
+		// Level 0 copies the depth texture, following levels reduce the level above them
+		const int levelWidth = std::max(1, width >> level);
+		const int levelHeight = std::max(1, height >> level);
+
+		glBindTextureUnit(0, (level == 0) ? m_depthTexture : m_pyramidTexture);
+		glBindImageTexture(0, m_pyramidTexture, static_cast<GLint>(level), GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+		m_buildShader->Set("sourceLevel", (level == 0) ? 0 : static_cast<int>(level) - 1);
+
+		glDispatchCompute((levelWidth + s_groupSize - 1) / s_groupSize, (levelHeight + s_groupSize - 1) / s_groupSize, 1);
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+	}
+
+	glBindTextureUnit(0, 0);
+	glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+	m_isValid = true;
+}
+
+void src::DepthPyramid::Bind(unsigned int unit) const
+{
+	glBindTextureUnit(unit, m_pyramidTexture);
+}
+
+void src::DepthPyramid::SetBuildShader(ShaderProgram* buildShader) noexcept
+{
+	m_buildShader = buildShader;
+}
+
+bool src::DepthPyramid::IsValid(void) const noexcept
+{
+	return m_isValid;
+}
+
+unsigned int src::DepthPyramid::GetLevelCount(void) const noexcept
+{
+	return m_levelCount;
+}
+
+void src::DepthPyramid::Resize(int width, int height)
+{
+	DeleteTextures();
+
+	m_width = width;
+	m_height = height;
+
+	// Full chain down to 1x1, sizes follow the GL rule (floor, at least 1)
+	m_levelCount = 1;
+
+	for (int size = std::max(width, height); size > 1; size >>= 1)
+		++m_levelCount;
+
+	glCreateTextures(GL_TEXTURE_2D, 1, &m_depthTexture);
+	glTextureStorage2D(m_depthTexture, 1, GL_DEPTH_COMPONENT32F, width, height);
+	glTextureParameteri(m_depthTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTextureParameteri(m_depthTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTextureParameteri(m_depthTexture, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+
+	glCreateTextures(GL_TEXTURE_2D, 1, &m_pyramidTexture);
+	glTextureStorage2D(m_pyramidTexture, static_cast<GLsizei>(m_levelCount), GL_R32F, width, height);
+	glTextureParameteri(m_pyramidTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTextureParameteri(m_pyramidTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTextureParameteri(m_pyramidTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(m_pyramidTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	m_isValid = false;
+}
+
+void src::DepthPyramid::DeleteTextures(void)
+{
+	glDeleteTextures(1, &m_depthTexture);
+	glDeleteTextures(1, &m_pyramidTexture);
+
+	m_depthTexture = 0;
+	m_pyramidTexture = 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+namespace src
+{
+	class ShaderProgram;
+
+	/*
+	*	Hierarchical depth buffer (Hi-Z). At the end of a frame the default framebuffer's depth is
+	*	copied and reduced by DepthPyramid.comp, every mip texel holding the furthest depth of the
+	*	texels below it. The next frame projects bounds with the previous view projection and
+	*	compares their nearest depth against a single mip level, a box behind every sampled texel
+	*	was hidden last frame. Terrain is static so the only error is the one frame latency.
+	*/
+	class DepthPyramid
+	{
+	public:
+		static constexpr unsigned int s_groupSize = 8;
+
+		DepthPyramid(void);
+		DepthPyramid(DepthPyramid const&) = delete;
+		DepthPyramid& operator=(DepthPyramid const&) = delete;
+		~DepthPyramid(void);
+
+		// Copies the current depth buffer and builds every level, call before the buffers are swapped
+		void Build(int width, int height);
+		void Bind(unsigned int unit) const;
+
+		void SetBuildShader(ShaderProgram* buildShader) noexcept;
+
+		// False until a frame has been built, the pyramid content is meaningless before that
+		bool			IsValid(void) const noexcept;
+		unsigned int	GetLevelCount(void) const noexcept;
+
+	private:
+		void Resize(int width, int height);
+		void DeleteTextures(void);
+
+		ShaderProgram*	m_buildShader;
+		unsigned int	m_depthTexture;
+		unsigned int	m_pyramidTexture;
+		unsigned int	m_levelCount;
+		int				m_width;
+		int				m_height;
+		bool			m_isValid;
+	};
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "terrain/Noise.h"
+
+#include "LibMath/matrix/Matrix4.h"
+#include "LibMath/vector/Vector4.h"
+
+namespace src
+{
+	// Matches the std140 'FrameConstants' uniform block of the terrain shaders
+	struct FrameConstants
+	{
+		static constexpr unsigned int s_binding = 0;
+
+		math::Matrix4<float> m_view;
+		math::Matrix4<float> m_projection;
+
+		// Camera of the frame the depth pyramid was built from (occlusion culling)
+		math::Matrix4<float> m_previousViewProjection;
+
+		// Relative to the terrain grid origin like every position given to the shaders, w unused (tessellation levels)
+		math::Vector4<float> m_cameraPosition;
+
+		// Lattice position of the grid origin per octave, the noise is sampled relative to it
+		noise::NoiseOrigin m_noiseOrigin;
+	};
+
+	static_assert(sizeof(noise::OctaveOrigin) == 4 * sizeof(float));
+	static_assert(sizeof(FrameConstants) == (3 * 16 + 4 + 4 * noise::s_maxOctaves) * sizeof(float));
+}
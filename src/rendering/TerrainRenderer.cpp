@@ -0,0 +1,397 @@
+#include "rendering/TerrainRenderer.h"
+#include "rendering/DepthPyramid.h"
+#include "rendering/mesh/Grid.h"
+#include "rendering/mesh/Vertex.h"
+#include "resource/shader/Shader.h"
+#include "utility/GraphicsFunctions.h"
+#include "utility/RingBuffer.h"
+
+#include "glad/glad.h"
+
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+
+namespace
+{
+	// Drawn chunks, occluded patches (std430 'TerrainStats')
+	constexpr size_t g_statsSize = 2 * sizeof(uint32_t);
+
+	constexpr GLbitfield g_statsMapFlags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	// Nanoseconds, waits are retried so this only bounds each call
+	constexpr GLuint64 g_fenceTimeout = 1000000000;
+}
+
+src::TerrainRenderer::TerrainRenderer(BufferAllocator& allocator, math::Vector2<float> minPos, math::Vector2<float> maxPos, unsigned int chunkCount, unsigned int divCount,
+									  noise::NoiseParams const& noiseParams)
+	: m_allocator(allocator), m_cullShader(nullptr), m_depthPyramid(nullptr), m_visibleChunksVersion(0), m_hasVisibleChunks(false), m_statsFences(s_statsLatency, nullptr),
+	  m_statsData(nullptr), m_statsStride(256), m_statsFrame(0), m_vao(0), m_indexCount(0)
+{
+	const float chunkSizeX = (maxPos[0] - minPos[0]) / static_cast<float>(chunkCount);
+	const float chunkSizeZ = (maxPos[1] - minPos[1]) / static_cast<float>(chunkCount);
+
+	m_chunkSize = math::Vector2<float>(chunkSizeX, chunkSizeZ);
+	m_gridCenter = (minPos + maxPos) * 0.5f;
+
+	// One chunk local mesh, shaders offset it by the chunk origin
+	std::vector<Vertex> vertices = Grid::GridVertices(
+		{0.0f, 0.0f, 0.0f},
+		{chunkSizeX, 0.0f, 0.0f},
+		{chunkSizeX, 0.0f, chunkSizeZ},
+		{0.0f, 0.0f, chunkSizeZ},
+		divCount
+	);
+	std::vector<int> indices = Grid::GridIndices(divCount);
+
+	m_indexCount = static_cast<unsigned int>(indices.size());
+
+	m_vertices = m_allocator.Allocate(sizeof(Vertex) * vertices.size(), sizeof(Vertex));
+	m_indices = m_allocator.Allocate(sizeof(int) * indices.size(), sizeof(int));
+	m_allocator.Upload(m_vertices, vertices.data(), m_vertices.m_size);
+	m_allocator.Upload(m_indices, indices.data(), m_indices.m_size);
+
+	// Conservative vertical bounds, displacement happens on the GPU
+	const float maxHeight = noise::MaxHeight(noiseParams);
+
+	for (unsigned int z = 0; z < chunkCount; ++z)
+	{
+		for (unsigned int x = 0; x < chunkCount; ++x)
+		{
+			const float originX = minPos[0] + chunkSizeX * static_cast<float>(x);
+			const float originZ = minPos[1] + chunkSizeZ * static_cast<float>(z);
+
+			ChunkData chunk;
+			chunk.m_boundsMin = math::Vector4<float>(originX, 0.0f, originZ, 0.0f);
+			chunk.m_boundsMax = math::Vector4<float>(originX + chunkSizeX, maxHeight, originZ + chunkSizeZ, 0.0f);
+
+			m_chunks.push_back(chunk);
+		}
+	}
+
+	m_chunkBuffer.SetStorage(m_chunks.data(), sizeof(ChunkData) * m_chunks.size(), 0);
+
+	// Lanes past the last chunk keep empty boxes at the origin, their bits are ignored
+	m_chunkBounds.resize((m_chunks.size() + BoxBatch::s_size - 1) / BoxBatch::s_size, BoxBatch{});
+
+	for (size_t i = 0; i < m_chunks.size(); ++i)
+	{
+		BoxBatch& batch = m_chunkBounds[i / BoxBatch::s_size];
+		const size_t lane = i % BoxBatch::s_size;
+
+		batch.m_minX[lane] = m_chunks[i].m_boundsMin[0];
+		batch.m_minY[lane] = m_chunks[i].m_boundsMin[1];
+		batch.m_minZ[lane] = m_chunks[i].m_boundsMin[2];
+		batch.m_maxX[lane] = m_chunks[i].m_boundsMax[0];
+		batch.m_maxY[lane] = m_chunks[i].m_boundsMax[1];
+		batch.m_maxZ[lane] = m_chunks[i].m_boundsMax[2];
+	}
+
+	m_visibleChunks.resize(m_chunks.size());
+	std::iota(m_visibleChunks.begin(), m_visibleChunks.end(), 0u);
+
+	// GPU written commands, never read back
+	m_commandBuffer.SetStorage(nullptr, sizeof(DrawCommand) * m_chunks.size(), 0);
+	m_drawCountBuffer.SetStorage(nullptr, sizeof(uint32_t), 0);
+
+	// One counter slot per frame in flight, each bound as a separate storage range
+	GLint storageAlignment = 0;
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+
+	if (storageAlignment > 0)
+		m_statsStride = (g_statsSize + storageAlignment - 1) / storageAlignment * storageAlignment;
+
+	const GLsizeiptr statsSize = static_cast<GLsizeiptr>(m_statsStride * s_statsLatency);
+
+	m_statsBuffer.SetStorage(nullptr, static_cast<size_t>(statsSize), g_statsMapFlags);
+	m_statsData = static_cast<std::byte*>(glMapNamedBufferRange(m_statsBuffer, 0, statsSize, g_statsMapFlags));
+
+	if (!m_statsData)
+		std::printf("Failed to map terrain stats buffer.\n");
+
+	m_stats.m_chunkCount = GetChunkCount();
+
+	// Chunk i reads element i, instanced attribute fetched at baseInstance
+	std::vector<uint32_t> chunkIds(m_chunks.size());
+	std::iota(chunkIds.begin(), chunkIds.end(), 0u);
+	m_chunkIds.SetStorage(chunkIds.data(), sizeof(uint32_t) * chunkIds.size(), 0);
+
+	// Set attributes
+	glCreateVertexArrays(1, &m_vao);
+
+	unsigned int index = 0;
+	unsigned int offset = 0;
+
+	SetAttribute(index, 3, offset); // Position attribute
+	SetAttribute(index, 3, offset); // Normal attribute
+	SetAttribute(index, 3, offset); // Tangent attribute
+	SetAttribute(index, 3, offset); // Bi - tangent attribute
+	SetAttribute(index, 2, offset); // Texture coord. attribute
+
+	// Chunk id attribute, one value per instance from binding 1
+	glEnableVertexArrayAttrib(m_vao, index);
+	glVertexArrayAttribBinding(m_vao, index, 1);
+	glVertexArrayAttribIFormat(m_vao, index, 1, GL_UNSIGNED_INT, 0);
+	glVertexArrayBindingDivisor(m_vao, 1, 1);
+
+	// Base vertex / first index in the commands are relative to the start of the arenas
+	glVertexArrayElementBuffer(m_vao, m_indices.m_buffer);
+	glVertexArrayVertexBuffer(m_vao, 0, m_vertices.m_buffer, 0, offset);
+	glVertexArrayVertexBuffer(m_vao, 1, m_chunkIds, 0, sizeof(uint32_t));
+}
+
+src::TerrainRenderer::~TerrainRenderer(void)
+{
+	for (void* fence : m_statsFences)
+	{
+		if (fence)
+			glDeleteSync(static_cast<GLsync>(fence));
+	}
+
+	if (m_statsData)
+		glUnmapNamedBuffer(m_statsBuffer);
+
+	glDeleteVertexArrays(1, &m_vao);
+	m_allocator.Free(m_vertices);
+	m_allocator.Free(m_indices);
+}
+
+void src::TerrainRenderer::Draw(RingBuffer& frameStream)
+{
+	BeginStats();
+
+	glBindVertexArray(m_vao);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, s_chunkBinding, m_chunkBuffer);
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, s_statsBinding, m_statsBuffer, static_cast<GLintptr>(m_statsFrame * m_statsStride), g_statsSize);
+
+	if (m_depthPyramid && m_depthPyramid->IsValid())
+		m_depthPyramid->Bind(s_depthPyramidUnit);
+
+	if (m_cullShader)
+		DrawCulled();
+	else
+		DrawStreamed(frameStream);
+
+	glBindVertexArray(0);
+
+	EndStats();
+}
+
+void src::TerrainRenderer::Recenter(math::Vector3<double> const& position) noexcept
+{
+	const double chunkSizeX = static_cast<double>(m_chunkSize[0]);
+	const double chunkSizeZ = static_cast<double>(m_chunkSize[1]);
+
+	// Whole chunk steps keep every vertex at the same world position, nothing swims
+	m_origin[0] = std::floor((position[0] - m_gridCenter[0]) / chunkSizeX + 0.5) * chunkSizeX;
+	m_origin[2] = std::floor((position[2] - m_gridCenter[1]) / chunkSizeZ + 0.5) * chunkSizeZ;
+}
+
+void src::TerrainRenderer::SetCullShader(ShaderProgram* cullShader) noexcept
+{
+	m_cullShader = cullShader;
+}
+
+void src::TerrainRenderer::SetDepthPyramid(DepthPyramid const* depthPyramid) noexcept
+{
+	m_depthPyramid = depthPyramid;
+}
+
+math::Vector3<double> const& src::TerrainRenderer::GetOrigin(void) const noexcept
+{
+	return m_origin;
+}
+
+uint32_t src::TerrainRenderer::GetChunkCount(void) const noexcept
+{
+	return static_cast<uint32_t>(m_chunks.size());
+}
+
+std::vector<src::TerrainRenderer::ChunkData> const& src::TerrainRenderer::GetChunks(void) const noexcept
+{
+	return m_chunks;
+}
+
+src::TerrainRenderer::Stats const& src::TerrainRenderer::GetStats(void) const noexcept
+{
+	return m_stats;
+}
+
+void src::TerrainRenderer::SetAttribute(unsigned int& index, int size, unsigned int& offset) const
+{
+	glEnableVertexArrayAttrib(m_vao, index);
+	glVertexArrayAttribBinding(m_vao, index, 0);
+	glVertexArrayAttribFormat(m_vao, index, size, GL_FLOAT, GL_FALSE, offset);
+
+	++index;
+	offset += size * sizeof(float);
+}
+
+void src::TerrainRenderer::Cull(Frustum const& frustum, uint64_t frustumVersion)
+{
+	if (!m_cullShader)
+	{
+		// Chunks never move in grid space, an unchanged frustum keeps the same chunks
+		if (!m_hasVisibleChunks || frustumVersion != m_visibleChunksVersion)
+			CullOnCpu(frustum);
+
+		m_visibleChunksVersion = frustumVersion;
+		m_hasVisibleChunks = true;
+		return;
+	}
+
+	const uint32_t chunkCount = GetChunkCount();
+	const uint32_t zero = 0;
+	const bool hasDrawCount = HasMultiDrawIndirectCount();
+
+	// Without a draw count every slot is drawn, zeroed commands have no instances
+	if (!hasDrawCount)
+		glClearNamedBufferData(m_commandBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+
+	glClearNamedBufferData(m_drawCountBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+
+	const DrawCommand command = MakeCommand(0);
+
+	m_cullShader->Use();
+	m_cullShader->Set("chunkCount", chunkCount);
+	m_cullShader->Set("indexCount", command.m_count);
+	m_cullShader->Set("firstIndex", command.m_firstIndex);
+	m_cullShader->Set("baseVertex", command.m_baseVertex);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, s_chunkBinding, m_chunkBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, s_commandBinding, m_commandBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, s_drawCountBinding, m_drawCountBuffer);
+
+	glDispatchCompute((chunkCount + s_cullGroupSize - 1) / s_cullGroupSize, 1, 1);
+
+	// Commands are consumed by the draw, the count is also copied into the stats
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+void src::TerrainRenderer::CullOnCpu(Frustum const& frustum)
+{
+	const uint32_t chunkCount = GetChunkCount();
+
+	m_visibleChunks.clear();
+
+	for (size_t batch = 0; batch < m_chunkBounds.size(); ++batch)
+	{
+		uint32_t visible = frustum.TestBoxes(m_chunkBounds[batch]);
+		const uint32_t first = static_cast<uint32_t>(batch * BoxBatch::s_size);
+
+		// Visit set bits only, most batches are either fully visible or fully culled
+		while (visible != 0)
+		{
+			const uint32_t chunk = first + static_cast<uint32_t>(std::countr_zero(visible));
+
+			if (chunk < chunkCount)
+				m_visibleChunks.push_back(chunk);
+
+			visible &= visible - 1;
+		}
+	}
+}
+
+void src::TerrainRenderer::DrawStreamed(RingBuffer& frameStream)
+{
+	const uint32_t chunkCount = static_cast<uint32_t>(m_visibleChunks.size());
+
+	if (chunkCount == 0)
+		return;
+
+	RingAllocation commands = frameStream.Allocate(sizeof(DrawCommand) * chunkCount, sizeof(uint32_t));
+
+	if (!commands.IsValid())
+		return;
+
+	DrawCommand* command = static_cast<DrawCommand*>(commands.m_data);
+
+	for (uint32_t i = 0; i < chunkCount; ++i)
+		command[i] = MakeCommand(m_visibleChunks[i]);
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands.m_buffer);
+	glMultiDrawElementsIndirect(GL_PATCHES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(commands.m_offset), static_cast<GLsizei>(chunkCount), 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void src::TerrainRenderer::DrawCulled(void)
+{
+	const uint32_t chunkCount = GetChunkCount();
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+
+	if (HasMultiDrawIndirectCount())
+	{
+		constexpr GLenum parameterBuffer = 0x80EE; // GL_PARAMETER_BUFFER, not in the GL 4.5 header
+
+		glBindBuffer(parameterBuffer, m_drawCountBuffer);
+		MultiDrawElementsIndirectCount(GL_PATCHES, GL_UNSIGNED_INT, 0, 0, static_cast<int>(chunkCount), 0);
+		glBindBuffer(parameterBuffer, 0);
+	}
+	else
+		glMultiDrawElementsIndirect(GL_PATCHES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(chunkCount), 0);
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void src::TerrainRenderer::BeginStats(void)
+{
+	const uint64_t offset = m_statsFrame * m_statsStride;
+	GLsync fence = static_cast<GLsync>(m_statsFences[m_statsFrame]);
+
+	// Slot written s_statsLatency frames ago, the wait only blocks when the GPU is that far behind
+	if (fence)
+	{
+		GLenum result = glClientWaitSync(fence, 0, 0);
+
+		while (result == GL_TIMEOUT_EXPIRED)
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, g_fenceTimeout);
+
+		glDeleteSync(fence);
+		m_statsFences[m_statsFrame] = nullptr;
+
+		if (result == GL_WAIT_FAILED)
+			std::printf("Failed to wait for terrain stats fence.\n");
+		else if (m_statsData)
+		{
+			uint32_t counters[2];
+			std::memcpy(counters, m_statsData + offset, sizeof(counters));
+
+			m_stats.m_drawnChunkCount = counters[0];
+			m_stats.m_patchCount = counters[0] * (m_indexCount / 4);
+			m_stats.m_occludedPatchCount = counters[1];
+		}
+	}
+
+	// Drawn chunks are known up front without GPU culling, otherwise the cull pass' count is copied
+	const uint32_t counters[2] = {m_cullShader ? 0u : static_cast<uint32_t>(m_visibleChunks.size()), 0u};
+
+	glClearNamedBufferSubData(m_statsBuffer, GL_RG32UI, static_cast<GLintptr>(offset), g_statsSize, GL_RG_INTEGER, GL_UNSIGNED_INT, counters);
+
+	if (m_cullShader)
+		glCopyNamedBufferSubData(m_drawCountBuffer, m_statsBuffer, 0, static_cast<GLintptr>(offset), sizeof(uint32_t));
+}
+
+void src::TerrainRenderer::EndStats(void)
+{
+	// Shader writes have to reach the mapping before the fence signals
+	glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+
+	m_statsFences[m_statsFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	m_statsFrame = (m_statsFrame + 1) % s_statsLatency;
+}
+
+src::TerrainRenderer::DrawCommand src::TerrainRenderer::MakeCommand(uint32_t chunk) const noexcept
+{
+	// Every chunk shares the same mesh, only the chunk id differs
+	DrawCommand command;
+	command.m_count = m_indexCount;
+	command.m_instanceCount = 1;
+	command.m_firstIndex = static_cast<uint32_t>(m_indices.m_offset / sizeof(int));
+	command.m_baseVertex = static_cast<int32_t>(m_vertices.m_offset / sizeof(Vertex));
+	command.m_baseInstance = chunk;
+
+	return command;
+}
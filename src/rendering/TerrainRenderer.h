@@ -0,0 +1,157 @@
+#pragma once
+
+#include "camera/Frustum.h"
+#include "terrain/Noise.h"
+#include "utility/Buffer.h"
+#include "utility/BufferAllocator.h"
+
+#include "LibMath/vector/Vector2.h"
+#include "LibMath/vector/Vector3.h"
+#include "LibMath/vector/Vector4.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace src
+{
+	class DepthPyramid;
+	class RingBuffer;
+	class ShaderProgram;
+
+	/*
+	*	Terrain split in square chunks sharing one patch mesh, every chunk is drawn by a single
+	*	glMultiDrawElementsIndirect call. Each command's baseInstance is the chunk index, an
+	*	instanced attribute turns it into the chunk id used to read the chunk SSBO (GL 4.5 has no
+	*	gl_DrawID / gl_BaseInstance without ARB_shader_draw_parameters).
+	*
+	*	With a cull shader set, commands are produced on the GPU: ChunkCull.comp frustum culls the
+	*	chunks and appends visible ones to the command buffer with an atomic counter, the count is
+	*	read by glMultiDrawElementsIndirectCount when available. Otherwise the command buffer is
+	*	cleared beforehand and every slot is drawn, empty commands draw nothing. Without a cull
+	*	shader chunks are tested against the frustum on the CPU, eight bounds per test, and only
+	*	the visible ones get a command.
+	*
+	*	With a depth pyramid set, the control shader tests every patch against the previous
+	*	frame's Hi-Z and gives occluded patches a tessellation level of 0. Counters written on the
+	*	GPU are read back a few frames later through persistently mapped memory, never stalling.
+	*
+	*	Chunks and patches are stored relative to the grid origin, a world position kept in double
+	*	precision and moved in whole chunk steps to follow the camera. Shaders only see these small
+	*	local coordinates: the view matrix is built relative to the origin and noise is sampled at the
+	*	origin, split per octave into a lattice cell and a fraction (FrameConstants::m_noiseOrigin), plus
+	*	the local position.
+	*/
+	class TerrainRenderer
+	{
+	public:
+		// Shader storage bindings
+		static constexpr unsigned int s_chunkBinding = 1;
+		static constexpr unsigned int s_commandBinding = 2;
+		static constexpr unsigned int s_drawCountBinding = 3;
+		static constexpr unsigned int s_statsBinding = 4;
+		static constexpr unsigned int s_cullGroupSize = 64;
+
+		// Texture unit of the depth pyramid in the terrain shaders
+		static constexpr unsigned int s_depthPyramidUnit = 8;
+
+		// Frames between writing GPU counters and reading them back
+		static constexpr unsigned int s_statsLatency = 3;
+
+		// Counters of a frame drawn s_statsLatency frames ago
+		struct Stats
+		{
+			uint32_t	m_chunkCount = 0;
+			uint32_t	m_drawnChunkCount = 0;
+			uint32_t	m_patchCount = 0; // Patches of the drawn chunks
+			uint32_t	m_occludedPatchCount = 0;
+		};
+
+		// Same layout as the GL indirect command
+		struct DrawCommand
+		{
+			uint32_t	m_count;
+			uint32_t	m_instanceCount;
+			uint32_t	m_firstIndex;
+			int32_t		m_baseVertex;
+			uint32_t	m_baseInstance;
+		};
+
+		// std430 'ChunkData' of the terrain shaders, chunk origin is m_boundsMin.xz
+		struct ChunkData
+		{
+			math::Vector4<float> m_boundsMin;
+			math::Vector4<float> m_boundsMax;
+		};
+
+		TerrainRenderer(void) = delete;
+		// 'noiseParams' must match the terrain shader's uniforms, chunk bounds are derived from them
+		TerrainRenderer(BufferAllocator& allocator, math::Vector2<float> minPos, math::Vector2<float> maxPos, unsigned int chunkCount, unsigned int divCount,
+						noise::NoiseParams const& noiseParams);
+		TerrainRenderer(TerrainRenderer const&) = delete;
+		TerrainRenderer& operator=(TerrainRenderer const&) = delete;
+		~TerrainRenderer(void);
+
+		/*
+		*	Dispatches the cull shader if one is set (it reads the FrameConstants block), otherwise
+		*	keeps the chunks intersecting 'frustum', given in grid local space. The CPU test is
+		*	skipped while 'frustumVersion' (CameraState::m_version) is the one of the previous call.
+		*	Call before binding the terrain program, every chunk is drawn until the first call.
+		*/
+		void Cull(Frustum const& frustum, uint64_t frustumVersion);
+
+		// Without a cull shader commands are streamed through the ring buffer, call between its BeginFrame / EndFrame
+		void Draw(RingBuffer& frameStream);
+
+		// Moves the grid origin by whole chunks so 'position' (world space) lies in the center chunk
+		void Recenter(math::Vector3<double> const& position) noexcept;
+
+		// Compute program culling chunks against the FrameConstants block, null to build commands on the CPU
+		void SetCullShader(ShaderProgram* cullShader) noexcept;
+
+		// Previous frame's Hi-Z, bound for the terrain program's occlusion test once valid
+		void SetDepthPyramid(DepthPyramid const* depthPyramid) noexcept;
+
+		// World position of the local origin of the chunks, y is always 0
+		math::Vector3<double> const&	GetOrigin(void) const noexcept;
+
+		uint32_t					GetChunkCount(void) const noexcept;
+		std::vector<ChunkData> const&	GetChunks(void) const noexcept;
+		Stats const&				GetStats(void) const noexcept;
+
+	private:
+		void SetAttribute(unsigned int& index, int size, unsigned int& offset) const;
+		void CullOnCpu(Frustum const& frustum);
+		void DrawStreamed(RingBuffer& frameStream);
+		void DrawCulled(void);
+		void BeginStats(void);
+		void EndStats(void);
+		DrawCommand MakeCommand(uint32_t chunk) const noexcept;
+
+		BufferAllocator&		m_allocator;
+		BufferAllocation		m_vertices;
+		BufferAllocation		m_indices;
+		Buffer					m_chunkIds;
+		Buffer					m_chunkBuffer;
+		Buffer					m_commandBuffer;
+		Buffer					m_drawCountBuffer;
+		Buffer					m_statsBuffer;
+		ShaderProgram*			m_cullShader;
+		DepthPyramid const*		m_depthPyramid;
+		std::vector<ChunkData>	m_chunks;
+		std::vector<BoxBatch>	m_chunkBounds; // Same bounds, 8 chunks per batch, CPU culling
+		std::vector<uint32_t>	m_visibleChunks;
+		uint64_t				m_visibleChunksVersion;
+		bool					m_hasVisibleChunks; // Culled at least once, the version is meaningful
+		math::Vector3<double>	m_origin;
+		math::Vector2<float>	m_chunkSize;
+		math::Vector2<float>	m_gridCenter; // Local
+		std::vector<void*>		m_statsFences; // GLsync
+		std::byte*				m_statsData;
+		uint64_t				m_statsStride;
+		unsigned int			m_statsFrame;
+		Stats					m_stats;
+		unsigned int			m_vao;
+		unsigned int			m_indexCount;
+	};
+}
@@ -0,0 +1,98 @@
+#include "rendering/TileTextures.h"
+#include "resource/shader/Shader.h"
+#include "terrain/HeightField.h"
+#include "terrain/TileStreamer.h"
+
+#include "LibMath/vector/Vector2.h"
+
+#include "glad/glad.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+src::TileTextures::TileTextures(TileStreamer const& streamer, int radius)
+	: m_streamer(streamer), m_texture(0), m_residentMask(0), m_radius(std::clamp(radius, 0, s_maxRadius)), m_centerX(0), m_centerZ(0)
+{
+	if (radius > s_maxRadius)
+		std::printf("Failed to map a tile radius of %d to layers, tiles past %d use the noise\n", radius, s_maxRadius);
+
+	m_width = 2 * m_radius + 1;
+	m_layers.resize(static_cast<size_t>(m_width) * m_width);
+
+	const int samplesPerSide = static_cast<int>(streamer.GetSettings().m_resolution) + 1;
+
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_texture);
+	glTextureStorage3D(m_texture, 1, GL_R32F, samplesPerSide, samplesPerSide, static_cast<GLsizei>(m_layers.size()));
+	glTextureParameteri(m_texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTextureParameteri(m_texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTextureParameteri(m_texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(m_texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+src::TileTextures::~TileTextures(void)
+{
+	glDeleteTextures(1, &m_texture);
+}
+
+void src::TileTextures::Update(math::Vector3<double> const& position)
+{
+	// Same center tile as the streamer
+	const float tileSize = TileWorldSize(m_streamer.GetSettings(), 0);
+	m_centerX = static_cast<int>(std::floor(position[0] / static_cast<double>(tileSize)));
+	m_centerZ = static_cast<int>(std::floor(position[2] / static_cast<double>(tileSize)));
+	m_residentMask = 0;
+
+	for (int z = m_centerZ - m_radius; z <= m_centerZ + m_radius; ++z)
+	{
+		for (int x = m_centerX - m_radius; x <= m_centerX + m_radius; ++x)
+		{
+			// Looked up by the tile's center, its edges are shared with the neighbours
+			HeightField const* tile = m_streamer.FindTile((static_cast<float>(x) + 0.5f) * tileSize, (static_cast<float>(z) + 0.5f) * tileSize);
+
+			if (!tile)
+				continue;
+
+			const int layerIndex = LayerCoord(z) * m_width + LayerCoord(x);
+			Layer& layer = m_layers[layerIndex];
+
+			// Only new tiles are uploaded, a layer keeps its tile while it stays in the area
+			if (layer.m_tile != tile || layer.m_x != x || layer.m_z != z)
+			{
+				const GLsizei samplesPerSide = static_cast<GLsizei>(tile->GetSamplesPerSide());
+
+				glTextureSubImage3D(m_texture, 0, 0, 0, layerIndex, samplesPerSide, samplesPerSide, 1, GL_RED, GL_FLOAT, tile->GetHeights().data());
+				layer = Layer{tile, x, z};
+			}
+
+			m_residentMask |= 1u << layerIndex;
+		}
+	}
+}
+
+void src::TileTextures::Bind(ShaderProgram const& program, math::Vector3<double> const& origin) const
+{
+	glBindTextureUnit(s_unit, m_texture);
+
+	// The center tile's first sample relative to the grid origin, both are far from 0 but close to each other
+	const double tileSize = static_cast<double>(TileWorldSize(m_streamer.GetSettings(), 0));
+	const math::Vector2<float> centerOrigin(static_cast<float>(static_cast<double>(m_centerX) * tileSize - origin[0]),
+											static_cast<float>(static_cast<double>(m_centerZ) * tileSize - origin[2]));
+
+	program.Set("tileResidentMask", m_residentMask);
+	program.Set("tileCenterLayer", math::Vector2<int>(LayerCoord(m_centerX), LayerCoord(m_centerZ)));
+	program.Set("tileCenterOrigin", centerOrigin);
+	program.Set("tileSize", static_cast<float>(tileSize));
+	program.Set("tileRadius", m_radius);
+}
+
+uint32_t src::TileTextures::GetResidentMask(void) const noexcept
+{
+	return m_residentMask;
+}
+
+int src::TileTextures::LayerCoord(int tileCoord) const noexcept
+{
+	// Non negative modulo, negative tile coordinates wrap like positive ones
+	return ((tileCoord % m_width) + m_width) % m_width;
+}
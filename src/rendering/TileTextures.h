@@ -0,0 +1,66 @@
+#pragma once
+
+#include "LibMath/vector/Vector3.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace src
+{
+	class HeightField;
+	class ShaderProgram;
+	class TileStreamer;
+
+	/*
+	*	Resident tiles of a TileStreamer uploaded as the layers of a 2D texture array, the terrain
+	*	evaluation shader samples them instead of evaluating the noise per vertex. Cached, baked and
+	*	eroded tiles are therefore what is drawn, coming back to an area only costs the upload.
+	*
+	*	Tiles of the (2 * radius + 1)^2 area around the camera map to a layer by their coordinates
+	*	modulo the area's width, so moving the area only uploads the tiles entering it. A bit per
+	*	layer tells the shader which layers hold a tile, areas not streamed in yet use the noise.
+	*/
+	class TileTextures
+	{
+	public:
+		// Texture unit of the tile heights in the terrain shaders
+		static constexpr unsigned int s_unit = 9;
+
+		// Layers are flagged in a 32 bit mask, a radius of 2 takes 25 of them
+		static constexpr int s_maxRadius = 2;
+
+		TileTextures(void) = delete;
+		// 'radius' should be the streamer's, tiles further than s_maxRadius are left to the noise
+		TileTextures(TileStreamer const& streamer, int radius);
+		TileTextures(TileTextures const&) = delete;
+		TileTextures& operator=(TileTextures const&) = delete;
+		~TileTextures(void);
+
+		// Uploads the streamer's tiles which changed, call after TileStreamer::Update with the same position
+		void Update(math::Vector3<double> const& position);
+
+		// Binds the texture and sets the tile uniforms, 'origin' is the terrain grid's (TerrainRenderer::GetOrigin)
+		void Bind(ShaderProgram const& program, math::Vector3<double> const& origin) const;
+
+		uint32_t GetResidentMask(void) const noexcept;
+
+	private:
+		struct Layer
+		{
+			HeightField const*	m_tile = nullptr;
+			int					m_x = 0;
+			int					m_z = 0;
+		};
+
+		int LayerCoord(int tileCoord) const noexcept;
+
+		TileStreamer const&	m_streamer;
+		std::vector<Layer>	m_layers;
+		unsigned int		m_texture;
+		uint32_t			m_residentMask;
+		int					m_radius;
+		int					m_width;
+		int					m_centerX;
+		int					m_centerZ;
+	};
+}
@@ -1,11 +1,13 @@
 #include "Grid.h"
-#include "utility/Buffer.h"
 #include "rendering/mesh/Vertex.h"
 
 #include "glad/glad.h"
 
-src::Grid::Grid(math::Vector2<float> minPos, math::Vector2<float> maxPos, unsigned int divCount)
-	: m_vao(0), m_indexCount(0)
+#include <cstdio>
+#include <numeric>
+
+src::Grid::Grid(BufferAllocator& allocator, math::Vector2<float> minPos, math::Vector2<float> maxPos, unsigned int divCount, float skirtDepth)
+	: m_allocator(allocator), m_vao(0), m_indexCount(0)
 {
 	// Calculate data for each vertex in grid for VBO buffer
 	std::vector<Vertex> vertices = GridVertices(
@@ -19,6 +21,9 @@ src::Grid::Grid(math::Vector2<float> minPos, math::Vector2<float> maxPos, unsign
 	// Calculate data for indices for EBO buffer
 	std::vector<int> indices = GridIndices(divCount);
 
+	if (skirtDepth > 0.0f)
+		AppendSkirts(vertices, indices, divCount, skirtDepth);
+
 	// Store index count for updating rendering
 	m_indexCount = static_cast<unsigned int>(indices.size());
 	
@@ -29,6 +34,8 @@ src::Grid::Grid(math::Vector2<float> minPos, math::Vector2<float> maxPos, unsign
 src::Grid::~Grid(void)
 {
 	glDeleteVertexArrays(1, &m_vao);
+	m_allocator.Free(m_vertices);
+	m_allocator.Free(m_indices);
 
 	m_vao = 0;
 	m_indexCount = 0;
@@ -38,7 +45,7 @@ void src::Grid::Update(void)
 {
 	// Draw grid with tessellation
 	glBindVertexArray(m_vao); // Bind vertex array
-	glDrawElements(GL_PATCHES, m_indexCount, GL_UNSIGNED_INT, 0); // Draw
+	glDrawElements(GL_PATCHES, m_indexCount, GL_UNSIGNED_INT, reinterpret_cast<const void*>(m_indices.m_offset)); // Draw
 	glBindVertexArray(0); // Unbind vertex array
 }
 
@@ -103,6 +110,98 @@ std::vector<int> src::Grid::GridIndices(unsigned int div)
 	return indices;
 }
 
+std::vector<int> src::Grid::GridIndices(unsigned int div, std::array<unsigned int, EDGE_COUNT> const& neighbourDivs)
+{
+	std::vector<int> indices = GridIndices(div);
+
+	// Border vertex -> closest vertex which also exists on the neighbour's edge
+	std::vector<int> remap(static_cast<size_t>(div + 1) * (div + 1));
+	std::iota(remap.begin(), remap.end(), 0);
+
+	for (unsigned int edge = 0; edge < EDGE_COUNT; ++edge)
+	{
+		const unsigned int neighbourDiv = neighbourDivs[edge];
+
+		if (neighbourDiv == 0 || neighbourDiv >= div)
+			continue;
+
+		if (div % neighbourDiv != 0)
+		{
+			std::printf("Failed to stitch grid edge, %u patches can not be split into %u.\n", div, neighbourDiv);
+			continue;
+		}
+
+		const unsigned int step = div / neighbourDiv;
+		std::vector<int> edgeIndices = GridEdgeIndices(div, static_cast<EGridEdge>(edge));
+
+		// Ties go towards the start of the edge, corners are on every grid and never move
+		for (unsigned int i = 0; i <= div; ++i)
+			remap[edgeIndices[i]] = edgeIndices[(i + (step - 1) / 2) / step * step];
+	}
+
+	// Border patches collapse into triangles, one patch per coarse segment keeps its full outer edge
+	for (int& index : indices)
+		index = remap[index];
+
+	return indices;
+}
+
+std::vector<int> src::Grid::GridEdgeIndices(unsigned int div, EGridEdge edge)
+{
+	std::vector<int> indices(div + 1);
+
+	const int last = static_cast<int>(div);
+	const int rowSize = last + 1;
+
+	for (int i = 0; i <= last; ++i)
+	{
+		switch (edge)
+		{
+		case EDGE_BOTTOM:
+			indices[i] = i; // Row 0, v0 -> v1
+			break;
+		case EDGE_RIGHT:
+			indices[i] = i * rowSize + last; // Last column, v1 -> v2
+			break;
+		case EDGE_TOP:
+			indices[i] = last * rowSize + (last - i); // Last row, v2 -> v3
+			break;
+		default:
+			indices[i] = (last - i) * rowSize; // Column 0, v3 -> v0
+			break;
+		}
+	}
+
+	return indices;
+}
+
+void src::Grid::AppendSkirts(std::vector<Vertex>& vertices, std::vector<int>& indices, unsigned int div, float depth)
+{
+	for (unsigned int edge = 0; edge < EDGE_COUNT; ++edge)
+	{
+		std::vector<int> edgeIndices = GridEdgeIndices(div, static_cast<EGridEdge>(edge));
+		const int firstBottom = static_cast<int>(vertices.size());
+
+		// Lowered copy of the border, texture coordinates are kept so the skirt looks like the edge
+		for (int index : edgeIndices)
+		{
+			Vertex bottom = vertices[index];
+			bottom.m_position[1] -= depth;
+
+			vertices.push_back(bottom);
+		}
+
+		// One patch per border segment, the top edge is the border segment itself
+		for (int i = 0; i < static_cast<int>(div); ++i)
+		{
+			indices.push_back(edgeIndices[i + 1]);
+			indices.push_back(edgeIndices[i]);
+			indices.push_back(firstBottom + i);
+			indices.push_back(firstBottom + i + 1);
+		}
+	}
+}
+
 void src::Grid::SetAttribute(unsigned int& index, int size, unsigned int& offset) const
 {
 	glEnableVertexArrayAttrib(m_vao, index);
@@ -115,13 +214,14 @@ void src::Grid::SetAttribute(unsigned int& index, int size, unsigned int& offset
 
 void src::Grid::SetData(std::vector<Vertex>& vertices, std::vector<int>& indices)
 {
-	// Create buffers
+	// Sub-allocate the shared buffers, vertex ranges start on a whole vertex
 	glCreateVertexArrays(1, &m_vao);
-	Buffer vbo, ebo;
+	m_vertices = m_allocator.Allocate(sizeof(Vertex) * vertices.size(), sizeof(Vertex));
+	m_indices = m_allocator.Allocate(sizeof(int) * indices.size(), sizeof(int));
 
 	// Set data
-	vbo.SetData(vertices.data(), sizeof(Vertex) * vertices.size());
-	ebo.SetData(indices.data(), sizeof(int) * indices.size());
+	m_allocator.Upload(m_vertices, vertices.data(), m_vertices.m_size);
+	m_allocator.Upload(m_indices, indices.data(), m_indices.m_size);
 	
 	// Set attributes
 	unsigned int index = 0;
@@ -133,6 +233,6 @@ void src::Grid::SetData(std::vector<Vertex>& vertices, std::vector<int>& indices
 	SetAttribute(index, 3, offset); // Bi - tangent attribute
 	SetAttribute(index, 2, offset); // Texture coord. attribute
 
-	glVertexArrayElementBuffer(m_vao, ebo);
-	glVertexArrayVertexBuffer(m_vao, 0, vbo, 0, offset);
+	glVertexArrayElementBuffer(m_vao, m_indices.m_buffer);
+	glVertexArrayVertexBuffer(m_vao, 0, m_vertices.m_buffer, static_cast<GLintptr>(m_vertices.m_offset), offset);
 }
\ No newline at end of file
@@ -1,34 +1,76 @@
 #pragma once
 
+#include "utility/BufferAllocator.h"
+
 #include "LibMath/vector/Vector2.h"
 #include "LibMath/vector/Vector3.h"
 
+#include <array>
 #include <vector>
 
 namespace src
 {
+	// Borders of a grid in GridVertices order, counter clockwise from the v0 -> v1 edge
+	enum EGridEdge : unsigned char
+	{
+		EDGE_BOTTOM = 0,
+		EDGE_RIGHT,
+		EDGE_TOP,
+		EDGE_LEFT,
+		EDGE_COUNT
+	};
+
+	/*
+	*	Quad patch grid. Independently built grids line up with their neighbours in two ways:
+	*	skirts hang a vertical strip below every border (hiding cracks whatever the neighbour
+	*	is), stitching collapses border vertices onto a coarser neighbour's edge vertices so
+	*	the shared edge is made of the same segments on both sides. Neither needs the
+	*	neighbour's mesh, only its patch count.
+	*/
 	class Grid
 	{
 	public:
 		Grid(void) = delete;
-		Grid(math::Vector2<float> minPos, math::Vector2<float> maxPos, unsigned int divCount);
+		Grid(BufferAllocator& allocator, math::Vector2<float> minPos, math::Vector2<float> maxPos, unsigned int divCount, float skirtDepth = 0.0f);
+		Grid(Grid const&) = delete;
+		Grid& operator=(Grid const&) = delete;
 		~Grid(void);
 
 		void Update(void);
-	
-	private:
-		std::vector<struct Vertex> GridVertices(
+
+		// Quad patch grid between four corners, shared with the chunked terrain renderer
+		static std::vector<struct Vertex> GridVertices(
 			math::Vector3<float> v0, math::Vector3<float> v1, 
 			math::Vector3<float> v2, math::Vector3<float> v3, 
 			unsigned int div
 		);
 
-		std::vector<int> GridIndices(unsigned int div);
+		static std::vector<int> GridIndices(unsigned int div);
+
+		/*
+		*	Patches stitched to neighbours with fewer patches per side, one entry per edge.
+		*	A neighbour count has to divide div, 0 or div leaves the edge as is.
+		*/
+		static std::vector<int> GridIndices(unsigned int div, std::array<unsigned int, EDGE_COUNT> const& neighbourDivs);
+
+		// Vertex indices along a border, in counter clockwise order
+		static std::vector<int> GridEdgeIndices(unsigned int div, EGridEdge edge);
+
+		/*
+		*	Appends a patch strip below every border, bottom vertices are lowered by depth.
+		*	Patch corner heights are offsets from the displaced surface in the evaluation shader.
+		*/
+		static void AppendSkirts(std::vector<Vertex>& vertices, std::vector<int>& indices, unsigned int div, float depth);
+	
+	private:
 
 		void SetAttribute(unsigned int& index, int size, unsigned int& offset) const;
 		void SetData(std::vector<math::Vector3<float>>& vertices, std::vector<int>& indices);
 		void SetData(std::vector<Vertex>& vertices, std::vector<int>& indices);
 
+		BufferAllocator& m_allocator;
+		BufferAllocation m_vertices;
+		BufferAllocation m_indices;
 		unsigned int m_vao;
 		unsigned int m_indexCount;
 	};
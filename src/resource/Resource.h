@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 namespace src
 {
 	class IResource
@@ -9,5 +11,59 @@ namespace src
 		virtual ~IResource(void) = default;
 
 		virtual bool LoadResource(const char* filePath) = 0;
+
+		/*
+		*	Asynchronous loading is split in two steps, LoadData runs on a loader thread (file I/O,
+		*	decoding) then Upload runs on the render thread (GL object creation).
+		*	By default everything happens in Upload through LoadResource.
+		*/
+		virtual bool LoadData(const char* filePath)
+		{
+			(void) filePath;
+			return true;
+		}
+
+		virtual bool Upload(const char* filePath)
+		{
+			return LoadResource(filePath);
+		}
+	};
+
+	enum EResourceState : unsigned char
+	{
+		RESOURCE_INVALID,	// Unknown or released handle
+		RESOURCE_LOADING,
+		RESOURCE_READY,
+		RESOURCE_FAILED
+	};
+
+	// Unique per resource type, lets the resource manager check types without dynamic_cast
+	using ResourceTypeId = const void*;
+
+	template<typename TResourceType>
+	inline ResourceTypeId GetResourceTypeId(void) noexcept
+	{
+		// Not const, read only data may be merged by identical COMDAT folding (/OPT:ICF) and ids would collide
+		static char s_typeId = 0;
+		return &s_typeId;
+	}
+
+	/*
+	*	Reference to a resource owned by the ResourceManager.
+	*	The generation changes every time a slot is reused, so handles to unloaded resources
+	*	resolve to null instead of to whatever replaced them.
+	*/
+	template<typename TResourceType>
+	struct ResourceHandle
+	{
+		bool IsValid(void) const noexcept
+		{
+			return m_generation != 0;
+		}
+
+		bool operator==(ResourceHandle const&) const = default;
+
+		uint32_t m_index = 0;
+		uint32_t m_generation = 0; // 0 is never used by a live resource
 	};
-}
\ No newline at end of file
+}
@@ -1,36 +1,32 @@
 #include "ResourceManager.h"
 #include "shader/Shader.h"
 
-src::ResourceManager* src::ResourceManager::m_instance = nullptr;
+#include <chrono>
 
-src::ShaderProgram* src::ResourceManager::LoadShader(const char* shaderProgramName, const char* vertShader, const char* fragShader)
+src::ResourceHandle<src::ShaderProgram> src::ResourceManager::LoadShader(const char* shaderProgramName, const char* vertShader, const char* fragShader)
 {
-	if (GetInstance()->HasResource(shaderProgramName))
-	{
-		std::printf("Failed to load shader '%s', shader already exists.\n", shaderProgramName);
-		return nullptr;
-	}
+	ResourceHandle<ShaderProgram> handle;
 
-	ShaderProgram* newProgram = new ShaderProgram();
-	GetInstance()->m_resources[shaderProgramName] = newProgram;
+	if (AcquireExisting(shaderProgramName, GetResourceTypeId<ShaderProgram>(), handle.m_index, handle.m_generation))
+		return handle;
+
+	auto newProgram = std::make_unique<ShaderProgram>();
 
 	newProgram->m_vertexShader = vertShader;
 	newProgram->m_fragShader = fragShader;
 	newProgram->CreateProgram();
 
-	return newProgram;
+	return Register(shaderProgramName, std::move(newProgram));
 }
 
-src::ShaderProgram* src::ResourceManager::LoadShader(const char* shaderProgramName, const char* vertShader, const char* fragShader, const char* tesCtrlShader, const char* tesEvalShader)
+src::ResourceHandle<src::ShaderProgram> src::ResourceManager::LoadShader(const char* shaderProgramName, const char* vertShader, const char* fragShader, const char* tesCtrlShader, const char* tesEvalShader)
 {
-	if (GetInstance()->HasResource(shaderProgramName))
-	{
-		std::printf("Failed to load shader '%s', shader already exists.\n", shaderProgramName);
-		return nullptr;
-	}
+	ResourceHandle<ShaderProgram> handle;
 
-	ShaderProgram* newProgram = new ShaderProgram();
-	GetInstance()->m_resources[shaderProgramName] = newProgram;
+	if (AcquireExisting(shaderProgramName, GetResourceTypeId<ShaderProgram>(), handle.m_index, handle.m_generation))
+		return handle;
+
+	auto newProgram = std::make_unique<ShaderProgram>();
 
 	newProgram->m_vertexShader = vertShader;
 	newProgram->m_fragShader = fragShader;
@@ -38,38 +34,365 @@ src::ShaderProgram* src::ResourceManager::LoadShader(const char* shaderProgramNa
 	newProgram->m_tesEvalShader = tesEvalShader;
 	newProgram->CreateTessellationProgram();
 
-	return newProgram;
+	return Register(shaderProgramName, std::move(newProgram));
+}
+
+src::ResourceHandle<src::ShaderProgram> src::ResourceManager::LoadComputeShader(const char* shaderProgramName, const char* compShader)
+{
+	ResourceHandle<ShaderProgram> handle;
+
+	if (AcquireExisting(shaderProgramName, GetResourceTypeId<ShaderProgram>(), handle.m_index, handle.m_generation))
+		return handle;
+
+	auto newProgram = std::make_unique<ShaderProgram>();
+
+	newProgram->m_computeShader = compShader;
+	newProgram->CreateProgram();
+
+	return Register(shaderProgramName, std::move(newProgram));
 }
 
 void src::ResourceManager::Unload(std::string const& fileName)
 {
-	if (GetInstance()->HasResource(fileName))
+	uint32_t index = 0;
+	uint32_t generation = 0;
+
 	{
-		delete GetInstance()->m_resources[fileName];
-		std::printf("Successfully unloaded resource '%s'.\n", fileName.c_str());
+		ResourceManager* instance = GetInstance();
+		std::shared_lock lock(instance->m_mutex);
+
+		auto it = instance->m_names.find(fileName);
+
+		if (it != instance->m_names.end())
+		{
+			index = it->second;
+			generation = instance->m_slots[index].m_generation;
+		}
 	}
-	else
+
+	if (!generation)
+	{
 		std::printf("Failed to unload resource '%s', resource was not found.\n", fileName.c_str());
+		return;
+	}
+
+	Release(index, generation);
 }
 
 void src::ResourceManager::ShutDown(void)
 {
-	for (auto resource : GetInstance()->m_resources)
-		Unload(resource.first);
+	ResourceManager* instance = GetInstance();
+	std::vector<std::unique_ptr<IResource>> resources;
+
+	// Let in flight loads finish, their uploads are dropped with the resources
+	if (instance->m_loaderPool)
+		instance->m_loaderPool->Wait();
+
+	{
+		std::lock_guard lock(instance->m_uploadMutex);
+		instance->m_pendingUploads.clear();
+	}
+
+	{
+		std::unique_lock lock(instance->m_mutex);
+
+		for (uint32_t i = 0; i < instance->m_slots.size(); ++i)
+		{
+			Slot& slot = instance->m_slots[i];
+
+			if (!slot.m_resource)
+				continue;
+
+			resources.push_back(std::move(slot.m_resource));
+			slot.m_name.clear();
+			slot.m_typeId = nullptr;
+			slot.m_refCount = 0;
+			slot.m_state = RESOURCE_INVALID;
+
+			if (++slot.m_generation == 0)
+				slot.m_generation = 1;
+
+			instance->m_freeSlots.push_back(i);
+		}
+
+		instance->m_names.clear();
+	}
+
+	// Destroyed outside of the lock, a resource may release handles of its own
+	resources.clear();
+}
+
+bool src::ResourceManager::AcquireExisting(std::string const& name, ResourceTypeId typeId, uint32_t& index, uint32_t& generation)
+{
+	ResourceManager* instance = GetInstance();
+	std::shared_lock lock(instance->m_mutex);
+
+	auto it = instance->m_names.find(name);
+
+	if (it == instance->m_names.end())
+		return false;
+
+	Slot& slot = instance->m_slots[it->second];
+
+	if (slot.m_typeId != typeId)
+	{
+		std::printf("Failed to load resource '%s', resource already loaded with a different type.\n", name.c_str());
+		return true;
+	}
+
+	slot.m_refCount.fetch_add(1, std::memory_order_relaxed);
+	index = it->second;
+	generation = slot.m_generation;
+
+	return true;
+}
+
+bool src::ResourceManager::Insert(std::string const& name, ResourceTypeId typeId, std::unique_ptr<IResource> resource, EResourceState state, uint32_t& index, uint32_t& generation)
+{
+	ResourceManager* instance = GetInstance();
+	std::unique_lock lock(instance->m_mutex);
+
+	if (!name.empty())
+	{
+		auto it = instance->m_names.find(name);
+
+		// Another thread loaded the same resource first, share its copy
+		if (it != instance->m_names.end())
+		{
+			Slot& slot = instance->m_slots[it->second];
+
+			if (slot.m_typeId != typeId)
+			{
+				std::printf("Failed to register resource '%s', resource already loaded with a different type.\n", name.c_str());
+				return false;
+			}
+
+			slot.m_refCount.fetch_add(1, std::memory_order_relaxed);
+			index = it->second;
+			generation = slot.m_generation;
+
+			return false;
+		}
+	}
+
+	if (instance->m_freeSlots.empty())
+	{
+		instance->m_freeSlots.push_back(static_cast<uint32_t>(instance->m_slots.size()));
+		instance->m_slots.emplace_back();
+	}
+
+	index = instance->m_freeSlots.back();
+	instance->m_freeSlots.pop_back();
+
+	Slot& slot = instance->m_slots[index];
+	slot.m_resource = std::move(resource);
+	slot.m_name = name;
+	slot.m_typeId = typeId;
+	slot.m_refCount = 1;
+	slot.m_state = state;
+	generation = slot.m_generation;
+
+	if (!name.empty())
+		instance->m_names.emplace(name, index);
+
+	return true;
+}
+
+src::IResource* src::ResourceManager::Find(uint32_t index, uint32_t generation, ResourceTypeId typeId)
+{
+	ResourceManager* instance = GetInstance();
+	std::shared_lock lock(instance->m_mutex);
+
+	if (index >= instance->m_slots.size())
+		return nullptr;
+
+	Slot const& slot = instance->m_slots[index];
+
+	if (slot.m_generation != generation || slot.m_typeId != typeId || slot.m_state.load(std::memory_order_acquire) != RESOURCE_READY)
+		return nullptr;
+
+	return slot.m_resource.get();
+}
+
+src::EResourceState src::ResourceManager::GetState(uint32_t index, uint32_t generation)
+{
+	ResourceManager* instance = GetInstance();
+	std::shared_lock lock(instance->m_mutex);
+
+	if (index >= instance->m_slots.size() || instance->m_slots[index].m_generation != generation)
+		return RESOURCE_INVALID;
+
+	return instance->m_slots[index].m_state.load(std::memory_order_acquire);
+}
+
+void src::ResourceManager::ProcessUploads(float budgetMilliseconds)
+{
+	using Clock = std::chrono::steady_clock;
+
+	ResourceManager* instance = GetInstance();
+	const Clock::time_point start = Clock::now();
+
+	while (true)
+	{
+		PendingUpload upload;
+
+		{
+			std::lock_guard lock(instance->m_uploadMutex);
+
+			if (instance->m_pendingUploads.empty())
+				return;
+
+			upload = instance->m_pendingUploads.front();
+			instance->m_pendingUploads.pop_front();
+		}
+
+		IResource* resource;
+		std::string name;
+
+		if (GetLoadingResource(upload.m_index, upload.m_generation, resource, name))
+			FinishLoad(upload.m_index, upload.m_generation, upload.m_isLoaded && resource->Upload(name.c_str()));
+
+		const std::chrono::duration<float, std::milli> elapsed = Clock::now() - start;
+
+		if (elapsed.count() >= budgetMilliseconds)
+			return;
+	}
+}
+
+void src::ResourceManager::StartAsyncLoad(uint32_t index, uint32_t generation)
+{
+	ResourceManager* instance = GetInstance();
+
+	std::call_once(instance->m_loaderPoolFlag, [instance]()
+	{
+		instance->m_loaderPool = std::make_unique<ThreadPool>(s_loaderThreadCount);
+	});
+
+	// The load holds its own reference so the resource outlives it even if every handle is released
+	AddReference(index, generation);
+
+	instance->m_loaderPool->Submit([instance, index, generation]()
+	{
+		IResource* resource;
+		std::string name;
+
+		if (!GetLoadingResource(index, generation, resource, name))
+			return;
+
+		// Finished on the render thread either way, FinishLoad may release the last reference
+		const bool isLoaded = resource->LoadData(name.c_str());
+
+		std::lock_guard lock(instance->m_uploadMutex);
+		instance->m_pendingUploads.push_back({index, generation, isLoaded});
+	});
+}
+
+bool src::ResourceManager::GetLoadingResource(uint32_t index, uint32_t generation, IResource*& resource, std::string& name)
+{
+	ResourceManager* instance = GetInstance();
+	std::shared_lock lock(instance->m_mutex);
 
-	delete m_instance;
-	m_instance = nullptr;
+	if (index >= instance->m_slots.size())
+		return false;
+
+	Slot const& slot = instance->m_slots[index];
+
+	if (slot.m_generation != generation || slot.m_state.load(std::memory_order_acquire) != RESOURCE_LOADING)
+		return false;
+
+	resource = slot.m_resource.get();
+	name = slot.m_name;
+
+	return true;
+}
+
+void src::ResourceManager::FinishLoad(uint32_t index, uint32_t generation, bool success)
+{
+	std::string name;
+
+	{
+		ResourceManager* instance = GetInstance();
+		std::shared_lock lock(instance->m_mutex);
+
+		if (index >= instance->m_slots.size() || instance->m_slots[index].m_generation != generation)
+			return;
+
+		// Release makes the loaded data visible to threads resolving the handle
+		instance->m_slots[index].m_state.store(success ? RESOURCE_READY : RESOURCE_FAILED, std::memory_order_release);
+		name = instance->m_slots[index].m_name;
+	}
+
+	if (success)
+		std::printf("Successfully loaded resource '%s'.\n", name.c_str());
+	else
+		std::printf("Failed to load resource '%s'.\n", name.c_str());
+
+	// Drop the reference taken by StartAsyncLoad
+	Release(index, generation);
+}
+
+void src::ResourceManager::AddReference(uint32_t index, uint32_t generation)
+{
+	ResourceManager* instance = GetInstance();
+	std::shared_lock lock(instance->m_mutex);
+
+	if (index < instance->m_slots.size() && instance->m_slots[index].m_generation == generation)
+		instance->m_slots[index].m_refCount.fetch_add(1, std::memory_order_relaxed);
 }
 
-bool src::ResourceManager::HasResource(std::string const& fileName)
+void src::ResourceManager::Release(uint32_t index, uint32_t generation)
 {
-	return GetInstance()->m_resources.contains(fileName);
+	ResourceManager* instance = GetInstance();
+
+	{
+		std::shared_lock lock(instance->m_mutex);
+
+		if (index >= instance->m_slots.size() || instance->m_slots[index].m_generation != generation)
+			return;
+
+		if (instance->m_slots[index].m_refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+	}
+
+	std::unique_ptr<IResource> resource;
+	std::string name;
+
+	{
+		std::unique_lock lock(instance->m_mutex);
+		Slot& slot = instance->m_slots[index];
+
+		// A lookup by name may have revived the resource, or another release already destroyed it
+		if (slot.m_generation != generation || slot.m_refCount.load(std::memory_order_acquire) != 0)
+			return;
+
+		resource = std::move(slot.m_resource);
+		name = std::move(slot.m_name);
+
+		if (!name.empty())
+			instance->m_names.erase(name);
+
+		slot.m_name.clear();
+		slot.m_typeId = nullptr;
+		slot.m_state = RESOURCE_INVALID;
+
+		// Skip 0 on wrap around, it marks invalid handles
+		if (++slot.m_generation == 0)
+			slot.m_generation = 1;
+
+		instance->m_freeSlots.push_back(index);
+	}
+
+	// Destroyed outside of the lock, a resource may release handles of its own
+	resource.reset();
+
+	if (!name.empty())
+		std::printf("Successfully unloaded resource '%s'.\n", name.c_str());
 }
 
 src::ResourceManager* src::ResourceManager::GetInstance(void)
 {
-	if (!m_instance)
-		m_instance = new ResourceManager();
+	// Initialization of function statics is thread safe
+	static ResourceManager instance;
 
-	return m_instance;
+	return &instance;
 }
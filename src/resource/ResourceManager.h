@@ -1,28 +1,68 @@
 #pragma once
 
 #include "Resource.h"
+#include "utility/ThreadPool.h"
 
+#include <atomic>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace src
 {
+	/*
+	*	Owns every loaded resource, resources are reference counted and destroyed when the last
+	*	handle is released. Lookups take a shared lock so loader threads can register resources
+	*	while the render thread resolves handles.
+	*/
 	class ResourceManager
 	{
 	public:
+		// Resolve a handle, null if the resource was unloaded or the type does not match
+		template<typename TResourceType>
+		static TResourceType* Get(ResourceHandle<TResourceType> handle);
+
+		// Lookup by name, null until the resource is ready
 		template<typename TResourceType>
 		static TResourceType* GetResource(std::string const& fileName);
-		
+
+		// Load the resource or add a reference to the already loaded one,
+		// a resource still loading asynchronously resolves to null until it is ready
+		template<typename TResourceType>
+		static ResourceHandle<TResourceType> Load(std::string const& fileName);
+
+		// Returns immediately, the handle resolves to null until the state is RESOURCE_READY
+		template<typename TResourceType>
+		static ResourceHandle<TResourceType> LoadAsync(std::string const& fileName);
+
+		template<typename TResourceType>
+		static EResourceState GetState(ResourceHandle<TResourceType> handle);
+
+		// Render thread only, runs pending GL uploads until the time budget is spent (at least one per call)
+		static void ProcessUploads(float budgetMilliseconds);
+
+		// Take ownership of a resource created elsewhere (generated meshes, tiles...), an empty name keeps it anonymous
+		template<typename TResourceType>
+		static ResourceHandle<TResourceType> Register(std::string const& name, std::unique_ptr<TResourceType> resource);
+
 		template<typename TResourceType>
-		static TResourceType* Load(std::string const& fileName);
+		static void AddReference(ResourceHandle<TResourceType> handle);
 
-		static class ShaderProgram* LoadShader(
+		template<typename TResourceType>
+		static void Release(ResourceHandle<TResourceType>& handle);
+
+		static ResourceHandle<class ShaderProgram> LoadShader(
 			const char* shaderProgramName,
 			const char* vertShader,
 			const char* fragShader
 		);
 
-		static class ShaderProgram* LoadShader(
+		static ResourceHandle<class ShaderProgram> LoadShader(
 			const char* shaderProgramName,
 			const char* vertShader,
 			const char* fragShader,
@@ -30,46 +70,163 @@ namespace src
 			const char* tesEvalShader
 		);
 
+		static ResourceHandle<class ShaderProgram> LoadComputeShader(
+			const char* shaderProgramName,
+			const char* compShader
+		);
+
+		// Release one reference held on a named resource
 		static void Unload(std::string const& fileName);
+
+		// Destroy every resource regardless of outstanding references
 		static void ShutDown(void);
 
 	private:
+		static constexpr unsigned int s_loaderThreadCount = 2;
+
+		struct Slot
+		{
+			std::unique_ptr<IResource>		m_resource;
+			std::string						m_name;
+			ResourceTypeId					m_typeId = nullptr;
+			std::atomic<uint32_t>			m_refCount = 0;
+			std::atomic<EResourceState>		m_state = RESOURCE_INVALID;
+			uint32_t						m_generation = 1;
+		};
+
+		// Failed loads are queued as well, finishing a load may destroy the resource and its GL objects
+		struct PendingUpload
+		{
+			uint32_t	m_index;
+			uint32_t	m_generation;
+			bool		m_isLoaded;
+		};
+
 		ResourceManager(void) = default;
 		ResourceManager(ResourceManager const& rManager) = delete;
 		ResourceManager& operator=(ResourceManager const& rManager) = delete;
 
-		static bool HasResource(std::string const& fileName);
+		static bool AcquireExisting(std::string const& name, ResourceTypeId typeId, uint32_t& index, uint32_t& generation);
+		static bool Insert(std::string const& name, ResourceTypeId typeId, std::unique_ptr<IResource> resource, EResourceState state, uint32_t& index, uint32_t& generation);
+		static IResource* Find(uint32_t index, uint32_t generation, ResourceTypeId typeId);
+		static EResourceState GetState(uint32_t index, uint32_t generation);
+		static void StartAsyncLoad(uint32_t index, uint32_t generation);
+		static bool GetLoadingResource(uint32_t index, uint32_t generation, IResource*& resource, std::string& name);
+		static void FinishLoad(uint32_t index, uint32_t generation, bool success);
+		static void AddReference(uint32_t index, uint32_t generation);
+		static void Release(uint32_t index, uint32_t generation);
+
 		static ResourceManager* GetInstance(void);
-		static ResourceManager* m_instance;
 
-		std::unordered_map<std::string, IResource*> m_resources;
+		// Deque keeps slot addresses stable while new slots are appended
+		std::deque<Slot>							m_slots;
+		std::vector<uint32_t>						m_freeSlots;
+		std::unordered_map<std::string, uint32_t>	m_names;
+		mutable std::shared_mutex					m_mutex;
+
+		// Created on the first asynchronous load
+		std::unique_ptr<ThreadPool>					m_loaderPool;
+		std::once_flag								m_loaderPoolFlag;
+		std::deque<PendingUpload>					m_pendingUploads;
+		std::mutex									m_uploadMutex;
 	};
 
+	template<typename TResourceType>
+	inline TResourceType* ResourceManager::Get(ResourceHandle<TResourceType> handle)
+	{
+		IResource* resource = Find(handle.m_index, handle.m_generation, GetResourceTypeId<TResourceType>());
+
+		// Type id was checked by Find
+		return static_cast<TResourceType*>(resource);
+	}
+
 	template<typename TResourceType>
 	inline TResourceType* ResourceManager::GetResource(std::string const& fileName)
 	{
-		bool hasResource = GetInstance()->m_resources.contains(fileName);
+		ResourceManager* instance = GetInstance();
+		std::shared_lock lock(instance->m_mutex);
+
+		auto it = instance->m_names.find(fileName);
+
+		if (it == instance->m_names.end())
+			return nullptr;
 
-		return (hasResource) ? 
-					dynamic_cast<TResourceType*>(GetInstance()->m_resources[fileName]) :
-					nullptr;
+		Slot const& slot = instance->m_slots[it->second];
+
+		// Same checks as Find, resources still loading are being written by a loader thread
+		if (slot.m_typeId != GetResourceTypeId<TResourceType>() || slot.m_state.load(std::memory_order_acquire) != RESOURCE_READY)
+			return nullptr;
+
+		return static_cast<TResourceType*>(slot.m_resource.get());
 	}
 
 	template<typename TResourceType>
-	inline TResourceType* ResourceManager::Load(std::string const& fileName)
+	inline ResourceHandle<TResourceType> ResourceManager::Load(std::string const& fileName)
 	{
-		if (!GetInstance()->HasResource(fileName))
+		ResourceHandle<TResourceType> handle;
+
+		if (AcquireExisting(fileName, GetResourceTypeId<TResourceType>(), handle.m_index, handle.m_generation))
+			return handle;
+
+		// Load outside of the lock, file I/O would otherwise stall every other thread
+		auto resource = std::make_unique<TResourceType>();
+
+		if (!resource->LoadResource(fileName.c_str()))
 		{
-			GetInstance()->m_resources[fileName] = new TResourceType();
-			GetInstance()->m_resources[fileName]->LoadResource(fileName.c_str());
+			std::printf("Failed to load resource '%s'.\n", fileName.c_str());
+			return handle;
+		}
 
+		Insert(fileName, GetResourceTypeId<TResourceType>(), std::move(resource), RESOURCE_READY, handle.m_index, handle.m_generation);
+
+		if (handle.IsValid())
 			std::printf("Successfully loaded resource '%s'.\n", fileName.c_str());
 
-			return GetInstance()->GetResource<TResourceType>(fileName);
-		}
-		else
-			std::printf("Failed to load resource, resource already loaded.\n");
+		return handle;
+	}
+
+	template<typename TResourceType>
+	inline ResourceHandle<TResourceType> ResourceManager::Register(std::string const& name, std::unique_ptr<TResourceType> resource)
+	{
+		ResourceHandle<TResourceType> handle;
+
+		if (resource)
+			Insert(name, GetResourceTypeId<TResourceType>(), std::move(resource), RESOURCE_READY, handle.m_index, handle.m_generation);
+
+		return handle;
+	}
+
+	template<typename TResourceType>
+	inline ResourceHandle<TResourceType> ResourceManager::LoadAsync(std::string const& fileName)
+	{
+		ResourceHandle<TResourceType> handle;
+
+		if (AcquireExisting(fileName, GetResourceTypeId<TResourceType>(), handle.m_index, handle.m_generation))
+			return handle;
+
+		// Only the thread which inserted the resource starts loading it
+		if (Insert(fileName, GetResourceTypeId<TResourceType>(), std::make_unique<TResourceType>(), RESOURCE_LOADING, handle.m_index, handle.m_generation))
+			StartAsyncLoad(handle.m_index, handle.m_generation);
+
+		return handle;
+	}
+
+	template<typename TResourceType>
+	inline EResourceState ResourceManager::GetState(ResourceHandle<TResourceType> handle)
+	{
+		return GetState(handle.m_index, handle.m_generation);
+	}
+
+	template<typename TResourceType>
+	inline void ResourceManager::AddReference(ResourceHandle<TResourceType> handle)
+	{
+		AddReference(handle.m_index, handle.m_generation);
+	}
 
-		return nullptr;
+	template<typename TResourceType>
+	inline void ResourceManager::Release(ResourceHandle<TResourceType>& handle)
+	{
+		Release(handle.m_index, handle.m_generation);
+		handle = ResourceHandle<TResourceType>();
 	}
-}
\ No newline at end of file
+}
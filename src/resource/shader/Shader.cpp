@@ -4,6 +4,88 @@
 
 #include "glad/glad.h"
 
+namespace
+{
+	// Copies one uniform between programs, types with no matching case are left to their default
+	void CopyUniformValue(unsigned int sourceProgram, int sourceLocation, unsigned int targetProgram, int targetLocation, unsigned int type)
+	{
+		float floats[16];
+		double doubles[16];
+		int ints[4];
+		unsigned int uints[4];
+
+		switch (type)
+		{
+		case GL_FLOAT:
+		case GL_FLOAT_VEC2:
+		case GL_FLOAT_VEC3:
+		case GL_FLOAT_VEC4:
+		case GL_FLOAT_MAT2:
+		case GL_FLOAT_MAT3:
+		case GL_FLOAT_MAT4:
+			glGetUniformfv(sourceProgram, sourceLocation, floats);
+			break;
+		case GL_DOUBLE:
+		case GL_DOUBLE_VEC2:
+		case GL_DOUBLE_VEC3:
+		case GL_DOUBLE_VEC4:
+		case GL_DOUBLE_MAT2:
+		case GL_DOUBLE_MAT3:
+		case GL_DOUBLE_MAT4:
+			glGetUniformdv(sourceProgram, sourceLocation, doubles);
+			break;
+		case GL_UNSIGNED_INT:
+		case GL_UNSIGNED_INT_VEC2:
+		case GL_UNSIGNED_INT_VEC3:
+		case GL_UNSIGNED_INT_VEC4:
+			glGetUniformuiv(sourceProgram, sourceLocation, uints);
+			break;
+		default:
+			glGetUniformiv(sourceProgram, sourceLocation, ints);
+			break;
+		}
+
+		switch (type)
+		{
+		case GL_FLOAT:				glProgramUniform1fv(targetProgram, targetLocation, 1, floats); break;
+		case GL_FLOAT_VEC2:			glProgramUniform2fv(targetProgram, targetLocation, 1, floats); break;
+		case GL_FLOAT_VEC3:			glProgramUniform3fv(targetProgram, targetLocation, 1, floats); break;
+		case GL_FLOAT_VEC4:			glProgramUniform4fv(targetProgram, targetLocation, 1, floats); break;
+		case GL_FLOAT_MAT2:			glProgramUniformMatrix2fv(targetProgram, targetLocation, 1, GL_FALSE, floats); break;
+		case GL_FLOAT_MAT3:			glProgramUniformMatrix3fv(targetProgram, targetLocation, 1, GL_FALSE, floats); break;
+		case GL_FLOAT_MAT4:			glProgramUniformMatrix4fv(targetProgram, targetLocation, 1, GL_FALSE, floats); break;
+		case GL_DOUBLE:				glProgramUniform1dv(targetProgram, targetLocation, 1, doubles); break;
+		case GL_DOUBLE_VEC2:		glProgramUniform2dv(targetProgram, targetLocation, 1, doubles); break;
+		case GL_DOUBLE_VEC3:		glProgramUniform3dv(targetProgram, targetLocation, 1, doubles); break;
+		case GL_DOUBLE_VEC4:		glProgramUniform4dv(targetProgram, targetLocation, 1, doubles); break;
+		case GL_DOUBLE_MAT2:		glProgramUniformMatrix2dv(targetProgram, targetLocation, 1, GL_FALSE, doubles); break;
+		case GL_DOUBLE_MAT3:		glProgramUniformMatrix3dv(targetProgram, targetLocation, 1, GL_FALSE, doubles); break;
+		case GL_DOUBLE_MAT4:		glProgramUniformMatrix4dv(targetProgram, targetLocation, 1, GL_FALSE, doubles); break;
+		case GL_UNSIGNED_INT:		glProgramUniform1uiv(targetProgram, targetLocation, 1, uints); break;
+		case GL_UNSIGNED_INT_VEC2:	glProgramUniform2uiv(targetProgram, targetLocation, 1, uints); break;
+		case GL_UNSIGNED_INT_VEC3:	glProgramUniform3uiv(targetProgram, targetLocation, 1, uints); break;
+		case GL_UNSIGNED_INT_VEC4:	glProgramUniform4uiv(targetProgram, targetLocation, 1, uints); break;
+		case GL_INT_VEC2:
+		case GL_BOOL_VEC2:			glProgramUniform2iv(targetProgram, targetLocation, 1, ints); break;
+		case GL_INT_VEC3:
+		case GL_BOOL_VEC3:			glProgramUniform3iv(targetProgram, targetLocation, 1, ints); break;
+		case GL_INT_VEC4:
+		case GL_BOOL_VEC4:			glProgramUniform4iv(targetProgram, targetLocation, 1, ints); break;
+		case GL_INT:
+		case GL_BOOL:
+		case GL_SAMPLER_1D:
+		case GL_SAMPLER_2D:
+		case GL_SAMPLER_3D:
+		case GL_SAMPLER_CUBE:
+		case GL_SAMPLER_2D_ARRAY:
+		case GL_SAMPLER_2D_SHADOW:
+		case GL_SAMPLER_BUFFER:		glProgramUniform1iv(targetProgram, targetLocation, 1, ints); break;
+		default:
+			break;
+		}
+	}
+}
+
 src::ShaderProgram::ShaderProgram(const char* vertexShader, const char* fragShader)
 	: m_vertexShader(vertexShader), m_fragShader(fragShader), m_programID(0)
 {
@@ -35,95 +117,95 @@ void src::ShaderProgram::Use(void) const
 // Scalar types
 void src::ShaderProgram::Set(const char* uniformName, bool value) const
 {
-	glUniform1i(glGetUniformLocation(m_programID, uniformName), value);
+	glUniform1i(GetUniformLocation(uniformName), value);
 }
 
 void src::ShaderProgram::Set(const char* uniformName, int value) const
 {
-	glUniform1i(glGetUniformLocation(m_programID, uniformName), value);
+	glUniform1i(GetUniformLocation(uniformName), value);
 }
 
 void src::ShaderProgram::Set(const char* uniformName, unsigned int value) const
 {
-	glUniform1ui(glGetUniformLocation(m_programID, uniformName), value);
+	glUniform1ui(GetUniformLocation(uniformName), value);
 }
 
 void src::ShaderProgram::Set(const char* uniformName, float value) const
 {
-	glUniform1f(glGetUniformLocation(m_programID, uniformName), value);
+	glUniform1f(GetUniformLocation(uniformName), value);
 }
  
 void src::ShaderProgram::Set(const char* uniformName, double value) const
 {
-	glUniform1d(glGetUniformLocation(m_programID, uniformName), value);
+	glUniform1d(GetUniformLocation(uniformName), value);
 }
 
 // Vector ints
 void src::ShaderProgram::Set(const char* uniformName, math::Vector2<int> const& vec) const
 {
-	glUniform2i(glGetUniformLocation(m_programID, uniformName), vec[0], vec[1]);
+	glUniform2i(GetUniformLocation(uniformName), vec[0], vec[1]);
 }
 
 void src::ShaderProgram::Set(const char* uniformName, math::Vector3<int> const& vec) const
 {
-	glUniform3i(glGetUniformLocation(m_programID, uniformName), vec[0], vec[1], vec[2]);
+	glUniform3i(GetUniformLocation(uniformName), vec[0], vec[1], vec[2]);
 }
 
 void src::ShaderProgram::Set(const char* uniformName, math::Vector4<int> const& vec) const
 {
-	glUniform4i(glGetUniformLocation(m_programID, uniformName), vec[0], vec[1], vec[2], vec[3]);
+	glUniform4i(GetUniformLocation(uniformName), vec[0], vec[1], vec[2], vec[3]);
 }
 
 // Vector floats
 void src::ShaderProgram::Set(const char* uniformName, math::Vector2<float> const& vec) const
 {
-	glUniform2f(glGetUniformLocation(m_programID, uniformName), vec[0], vec[1]);
+	glUniform2f(GetUniformLocation(uniformName), vec[0], vec[1]);
 }
 
 void src::ShaderProgram::Set(const char* uniformName, math::Vector3<float> const& vec) const
 {
-	glUniform3f(glGetUniformLocation(m_programID, uniformName), vec[0], vec[1], vec[2]);
+	glUniform3f(GetUniformLocation(uniformName), vec[0], vec[1], vec[2]);
 }
 
 void src::ShaderProgram::Set(const char* uniformName, math::Vector4<float> const& vec) const
 {
-	glUniform4f(glGetUniformLocation(m_programID, uniformName), vec[0], vec[1], vec[2], vec[3]);
+	glUniform4f(GetUniformLocation(uniformName), vec[0], vec[1], vec[2], vec[3]);
 }
 
 // Vector double
 void src::ShaderProgram::Set(const char* uniformName, math::Vector2<double> const& vec) const
 {
-	glUniform2d(glGetUniformLocation(m_programID, uniformName), vec[0], vec[1]);
+	glUniform2d(GetUniformLocation(uniformName), vec[0], vec[1]);
 }
 
 void src::ShaderProgram::Set(const char* uniformName, math::Vector3<double> const& vec) const
 {
-	glUniform3d(glGetUniformLocation(m_programID, uniformName), vec[0], vec[1], vec[2]);
+	glUniform3d(GetUniformLocation(uniformName), vec[0], vec[1], vec[2]);
 }
 
 void src::ShaderProgram::Set(const char* uniformName, math::Vector4<double> const& vec) const
 {
-	glUniform4d(glGetUniformLocation(m_programID, uniformName), vec[0], vec[1], vec[2], vec[3]);
+	glUniform4d(GetUniformLocation(uniformName), vec[0], vec[1], vec[2], vec[3]);
 }
 
 // Matrix float
 void src::ShaderProgram::Set(const char* uniformName, const math::Matrix2<float>* matrix) const
 {
-	int location = glGetUniformLocation(m_programID, uniformName);
+	int location = GetUniformLocation(uniformName);
 
 	glUniformMatrix2fv(location, 1, GL_FALSE, reinterpret_cast<const float*>(matrix));
 }
 
 void src::ShaderProgram::Set(const char* uniformName, const math::Matrix3<float>* matrix) const
 {
-	int location = glGetUniformLocation(m_programID, uniformName);
+	int location = GetUniformLocation(uniformName);
 
 	glUniformMatrix3fv(location, 1, GL_FALSE, reinterpret_cast<const float*>(matrix));
 }
 
 void src::ShaderProgram::Set(const char* uniformName, const math::Matrix4<float>* matrix) const
 {
-	int location = glGetUniformLocation(m_programID, uniformName);
+	int location = GetUniformLocation(uniformName);
 
 	glUniformMatrix4fv(location, 1, GL_FALSE, reinterpret_cast<const float*>(matrix));
 }
@@ -131,21 +213,21 @@ void src::ShaderProgram::Set(const char* uniformName, const math::Matrix4<float>
 // Matrix double
 void src::ShaderProgram::Set(const char* uniformName, const math::Matrix2<double>* matrix) const
 {
-	int location = glGetUniformLocation(m_programID, uniformName);
+	int location = GetUniformLocation(uniformName);
 
 	glUniformMatrix2dv(location, 1, GL_FALSE, reinterpret_cast<const double*>(matrix));
 }
 
 void src::ShaderProgram::Set(const char* uniformName, const math::Matrix3<double>* matrix) const
 {
-	int location = glGetUniformLocation(m_programID, uniformName);
+	int location = GetUniformLocation(uniformName);
 
 	glUniformMatrix3dv(location, 1, GL_FALSE, reinterpret_cast<const double*>(matrix));
 }
 
 void src::ShaderProgram::Set(const char* uniformName, const math::Matrix4<double>* matrix) const
 {
-	int location = glGetUniformLocation(m_programID, uniformName);
+	int location = GetUniformLocation(uniformName);
 
 	glUniformMatrix4dv(location, 1, GL_FALSE, reinterpret_cast<const double*>(matrix));
 }
@@ -160,50 +242,62 @@ const std::string& src::ShaderProgram::GetFragmentShaderName(void) const
     return m_fragShader;
 }
 
-void src::ShaderProgram::CreateProgram(void)
+const std::string& src::ShaderProgram::GetProgramName(void) const
 {
-    // Don't create OpenGL program twice
-    if (m_programID)
-        return;
-     
-	// Resource manager will only load if resource does not exist
-	Shader* vShader = ResourceManager::Load<Shader>(m_vertexShader);
-	Shader* fShader = ResourceManager::Load<Shader>(m_fragShader);
-
-    if (!vShader || !fShader)
-    {
-        std::printf("Failed to compute shader.\n");
-        return;
-    }
-
-	if (!vShader->GetShaderType() ||
-		!fShader->GetShaderType())
-	{
-		std::printf("Failed to create shader program. Error: vertex or fragment shader error.\n");
+	// Compute programs have no vertex stage
+	return m_vertexShader.empty() ? m_computeShader : m_vertexShader;
+}
+
+void src::ShaderProgram::EnableHotReload(void)
+{
+	if (m_fileWatcher)
 		return;
+
+	m_fileWatcher = std::make_unique<FileWatcher>();
+
+	for (std::string const* stageName : {&m_vertexShader, &m_fragShader, &m_tesCtrlShader, &m_tesEvalShader, &m_computeShader})
+	{
+		if (!stageName->empty())
+			m_fileWatcher->Watch(*stageName);
 	}
-	
-	m_programID = glCreateProgram();
-	glAttachShader(m_programID, vShader->GetShader());
-	glAttachShader(m_programID, fShader->GetShader());
-	glLinkProgram(m_programID);
+}
+
+bool src::ShaderProgram::ReloadIfChanged(void)
+{
+	if (!m_fileWatcher || m_fileWatcher->PollChanges().empty())
+		return false;
 
-	int result;
-	glGetProgramiv(m_programID, GL_LINK_STATUS, &result);
+	// The current program stays in use unless the new one links
+	const unsigned int program = LinkProgram();
 
-	if (!result)
+	if (!program)
 	{
-		constexpr int bufferSize = 2500;
-		char infoLog[bufferSize];
+		std::printf("Failed to reload shader program '%s', keeping the previous version.\n", GetProgramName().c_str());
+		return false;
+	}
+
+	if (m_programID)
+	{
+		CopyUniforms(m_programID, program);
+		glDeleteProgram(m_programID);
+	}
+
+	// Locations may differ in the new program
+	m_programID = program;
+	m_uniformLocations.clear();
 
-		glGetProgramInfoLog(m_programID, bufferSize, nullptr, infoLog);
-		std::printf("Failed to link shader program, reason: %s\n", infoLog);
+	std::printf("Successfully reloaded shader program '%s'.\n", GetProgramName().c_str());
+
+	return true;
+}
 
+void src::ShaderProgram::CreateProgram(void)
+{
+	// Don't create OpenGL program twice
+	if (m_programID)
 		return;
-	}
 
-	glDeleteShader(vShader->GetShader());
-	glDeleteShader(fShader->GetShader());
+	m_programID = LinkProgram();
 }
 
 void src::ShaderProgram::CreateTessellationProgram(void)
@@ -212,50 +306,125 @@ void src::ShaderProgram::CreateTessellationProgram(void)
 	if (m_programID)
 		return;
 
-	// Resource manager will only load if resource does not exist
-	Shader* vShader = ResourceManager::Load<Shader>(m_vertexShader);
-	Shader* fShader = ResourceManager::Load<Shader>(m_fragShader);
-	Shader* tcShader = ResourceManager::Load<Shader>(m_tesCtrlShader);
-	Shader* teShader = ResourceManager::Load<Shader>(m_tesEvalShader);
+	m_programID = LinkProgram();
+}
+
+unsigned int src::ShaderProgram::LinkProgram(void) const
+{
+	// Stages are shared with other programs through the resource manager, empty names are unused stages
+	std::string const* stageNames[] = {&m_vertexShader, &m_fragShader, &m_tesCtrlShader, &m_tesEvalShader, &m_computeShader};
+	ResourceHandle<Shader> stages[5];
+	bool stagesLoaded = true;
 
-	if (!vShader || !fShader || !tcShader || !teShader)
+	for (int i = 0; i < 5; ++i)
 	{
-		std::printf("Failed to compute shader.\n");
-		return;
+		if (stageNames[i]->empty())
+			continue;
+
+		stages[i] = ResourceManager::Load<Shader>(*stageNames[i]);
+		stagesLoaded &= ResourceManager::Get(stages[i]) != nullptr;
 	}
 
-	if (!vShader->GetShaderType() ||
-		!fShader->GetShaderType() ||
-		!tcShader->GetShaderType() ||
-		!teShader->GetShaderType())
+	unsigned int program = 0;
+
+	if (!stagesLoaded)
+		std::printf("Failed to compute shader.\n");
+	else
 	{
-		std::printf("Failed to create shader program. Error: vertex or fragment or tessellation shader error.\n");
-		return;
+		program = glCreateProgram();
+
+		for (ResourceHandle<Shader> stage : stages)
+		{
+			if (stage.IsValid())
+				glAttachShader(program, ResourceManager::Get(stage)->GetShader());
+		}
+
+		glLinkProgram(program);
+
+		int result;
+		glGetProgramiv(program, GL_LINK_STATUS, &result);
+
+		if (!result)
+		{
+			constexpr int bufferSize = 2500;
+			char infoLog[bufferSize];
+
+			glGetProgramInfoLog(program, bufferSize, nullptr, infoLog);
+			std::printf("Failed to link shader program, reason: %s\n", infoLog);
+
+			glDeleteProgram(program);
+			program = 0;
+		}
 	}
 
-	m_programID = glCreateProgram();
-	glAttachShader(m_programID, vShader->GetShader());
-	glAttachShader(m_programID, fShader->GetShader());
-	glAttachShader(m_programID, tcShader->GetShader());
-	glAttachShader(m_programID, teShader->GetShader());
-	glLinkProgram(m_programID);
+	// Linked programs keep their own copy of the stages, unused shaders are deleted on release
+	for (ResourceHandle<Shader>& stage : stages)
+		ResourceManager::Release(stage);
+
+	return program;
+}
+
+void src::ShaderProgram::CopyUniforms(unsigned int sourceProgram, unsigned int targetProgram) const
+{
+	constexpr int nameSize = 256;
+	char name[nameSize];
+
+	int uniformCount = 0;
+	glGetProgramiv(targetProgram, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+	// Default block uniforms, arrays are reported once as 'name[0]'
+	for (int i = 0; i < uniformCount; ++i)
+	{
+		int size;
+		unsigned int type;
+		glGetActiveUniform(targetProgram, i, nameSize, nullptr, &size, &type, name);
+
+		std::string baseName = name;
+
+		if (baseName.ends_with("[0]"))
+			baseName.resize(baseName.size() - 3);
+
+		for (int element = 0; element < size; ++element)
+		{
+			const std::string elementName = (size > 1) ? baseName + '[' + std::to_string(element) + ']' : std::string(name);
+
+			const int sourceLocation = glGetUniformLocation(sourceProgram, elementName.c_str());
+			const int targetLocation = glGetUniformLocation(targetProgram, elementName.c_str());
+
+			// Block members have no location, renamed uniforms are not in the old program
+			if (sourceLocation >= 0 && targetLocation >= 0)
+				CopyUniformValue(sourceProgram, sourceLocation, targetProgram, targetLocation, type);
+		}
+	}
 
-	int result;
-	glGetProgramiv(m_programID, GL_LINK_STATUS, &result);
+	int blockCount = 0;
+	glGetProgramiv(targetProgram, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
 
-	if (!result)
+	// Uniform block bindings
+	for (int i = 0; i < blockCount; ++i)
 	{
-		constexpr int bufferSize = 2500;
-		char infoLog[bufferSize];
+		glGetActiveUniformBlockName(targetProgram, i, nameSize, nullptr, name);
 
-		glGetProgramInfoLog(m_programID, bufferSize, nullptr, infoLog);
-		std::printf("Failed to link shader program, reason: %s\n", infoLog);
+		const unsigned int sourceIndex = glGetUniformBlockIndex(sourceProgram, name);
 
-		return;
+		if (sourceIndex == GL_INVALID_INDEX)
+			continue;
+
+		int binding;
+		glGetActiveUniformBlockiv(sourceProgram, sourceIndex, GL_UNIFORM_BLOCK_BINDING, &binding);
+		glUniformBlockBinding(targetProgram, i, binding);
 	}
+}
+
+int src::ShaderProgram::GetUniformLocation(const char* uniformName) const
+{
+	auto it = m_uniformLocations.find(uniformName);
+
+	if (it != m_uniformLocations.end())
+		return it->second;
+
+	const int location = glGetUniformLocation(m_programID, uniformName);
+	m_uniformLocations.emplace(uniformName, location);
 
-	glDeleteShader(vShader->GetShader());
-	glDeleteShader(fShader->GetShader());
-	glDeleteShader(tcShader->GetShader());
-	glDeleteShader(teShader->GetShader());
+	return location;
 }
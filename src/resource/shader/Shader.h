@@ -1,6 +1,7 @@
 #pragma once
 
 #include "resource/Resource.h"
+#include "utility/FileWatcher.h"
 
 #include "LibMath/vector/Vector2.h"
 #include "LibMath/vector/Vector3.h"
@@ -9,7 +10,9 @@
 #include "LibMath/matrix/Matrix3.h"
 #include "LibMath/matrix/Matrix4.h"
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace src
 {
@@ -57,18 +60,33 @@ namespace src
 
         const std::string& GetVertexShaderName(void) const;
         const std::string& GetFragmentShaderName(void) const;
+		const std::string& GetProgramName(void) const;
+
+		// Watch the stage source files for ReloadIfChanged
+		void EnableHotReload(void);
+
+		// Call at a frame boundary, relinks after a source changed and swaps the program only if
+		// linking succeeded. Uniform values and block bindings carry over to the new program
+		bool ReloadIfChanged(void);
 
 	private:
 		void CreateProgram(void);
 		void CreateTessellationProgram(void);
+		unsigned int LinkProgram(void) const;
+		void CopyUniforms(unsigned int sourceProgram, unsigned int targetProgram) const;
+		int GetUniformLocation(const char* uniformName) const;
 
 		std::string m_vertexShader;
 		std::string m_fragShader;
 		std::string m_tesCtrlShader;
 		std::string m_tesEvalShader;
+		std::string m_computeShader;
 		
 		unsigned int m_programID = 0;
 
+		std::unique_ptr<FileWatcher> m_fileWatcher;
+		mutable std::unordered_map<std::string, int> m_uniformLocations;
+
         friend class ResourceManager;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,4 @@
 #include "resource/shader/ShaderResource.h"
-#include "utility/FileData.h"
 
 #include "glad/glad.h"
 #include <iostream>
@@ -9,7 +8,18 @@ src::Shader::Shader(void)
 {
 }
 
+src::Shader::~Shader(void)
+{
+	// Attached shaders are only flagged for deletion until their programs are deleted
+	glDeleteShader(m_shader);
+}
+
 bool src::Shader::LoadResource(const char* fileName)
+{
+	return LoadData(fileName) && Upload(fileName);
+}
+
+bool src::Shader::LoadData(const char* fileName)
 {
 	// Check shader type (vert, frag, etc...)
 	m_shaderType = ShaderType(fileName);
@@ -17,21 +27,45 @@ bool src::Shader::LoadResource(const char* fileName)
 	if (m_shaderType == EShaderType::INVALID_SHADER)
 		return false;
 
-	// Load shader file to memory
-	FileData fileData = fileData.ReadFile(fileName);
+	// Map shader file, the source is handed to the driver with its length so no copy is needed
+	if (!m_sourceFile.Open(fileName))
+	{
+		m_shaderType = EShaderType::INVALID_SHADER;
+		return false;
+	}
 
-	if (!fileData.m_size)
+	if (m_sourceFile.GetSize() == 0)
 	{
 		std::printf("Failed to process shader '%s'. Shader file contains no content.\n", fileName);
+		m_sourceFile.Close();
 		m_shaderType = EShaderType::INVALID_SHADER;
 		return false;
 	}
 
+	// Touch every page so the disk reads happen here rather than on the render thread
+	volatile std::byte pageSum = std::byte(0);
+
+	for (uint64_t offset = 0; offset < m_sourceFile.GetSize(); offset += 4096)
+		pageSum = pageSum ^ m_sourceFile.GetData()[offset];
+
+	return true;
+}
+
+bool src::Shader::Upload(const char* fileName)
+{
+	(void) fileName;
+
+	if (!m_sourceFile.IsOpen())
+		return false;
+
 	// Create shader
 	m_shader = glCreateShader(m_shaderType);
-	// TODO: check if length (last param) needs to be nullptr
-	glShaderSource(m_shader, 1, &fileData.m_fileContent, &fileData.m_size);
+	const char* source = reinterpret_cast<const char*>(m_sourceFile.GetData());
+	const int sourceLength = static_cast<int>(m_sourceFile.GetSize());
+
+	glShaderSource(m_shader, 1, &source, &sourceLength);
 	glCompileShader(m_shader);
+	m_sourceFile.Close();
 
 	int result;
 	glGetShaderiv(m_shader, GL_COMPILE_STATUS, &result);
@@ -48,7 +82,6 @@ bool src::Shader::LoadResource(const char* fileName)
 		return false;
 	}
 
-	fileData.Clear();
     return true;
 }
 
@@ -80,6 +113,8 @@ src::EShaderType src::Shader::ShaderType(const char* fileName) const
 		return EShaderType::FRAGMENT_SHADER;
 	case 'g':
 		return EShaderType::GEOMETRY_SHADER;
+	case 'c':
+		return EShaderType::COMPUTE_SHADER;
 	case 't':
 		if (fileName[pos + 4] == 'c')
 			return EShaderType::TESSELLATION_CONTROL_SHADER;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "resource/Resource.h"
+#include "utility/MappedFile.h"
 
 namespace src
 {
@@ -11,22 +12,26 @@ namespace src
 		FRAGMENT_SHADER = 0x8B30,
 		GEOMETRY_SHADER = 0x8DD9,
 		TESSELLATION_CONTROL_SHADER = 0x8E88,
-		TESSELLATION_EVAL_SHADER = 0x8E87
+		TESSELLATION_EVAL_SHADER = 0x8E87,
+		COMPUTE_SHADER = 0x91B9
 	};
 
 	class Shader final : public IResource
 	{
 	public:
 		Shader(void);
-		~Shader(void) = default;
+		~Shader(void) override;
 
 		bool LoadResource(const char* fileName) override;
+		bool LoadData(const char* fileName) override;
+		bool Upload(const char* fileName) override;
 
 		unsigned int GetShader(void) const noexcept;
 		EShaderType GetShaderType(void) const noexcept;
 
 	private:
 		EShaderType ShaderType(const char* fileName) const;
+		MappedFile m_sourceFile; // Only open between LoadData and Upload
 		unsigned int m_shader;
 		EShaderType m_shaderType;
 	};
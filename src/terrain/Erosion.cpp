@@ -0,0 +1,474 @@
+#include "terrain/Erosion.h"
+#include "terrain/HeightField.h"
+#include "utility/Hash.h"
+#include "utility/ThreadPool.h"
+#include "utility/Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <vector>
+
+namespace
+{
+	// Rows per thread pool chunk of a thermal iteration
+	constexpr size_t g_thermalGrainSize = 16;
+
+	// Deterministic on every platform, unlike the standard distributions (splitmix64)
+	class Random
+	{
+	public:
+		explicit Random(uint64_t seed) noexcept
+			: m_state(seed)
+		{
+		}
+
+		uint64_t Next(void) noexcept
+		{
+			uint64_t value = (m_state += 0x9E3779B97F4A7C15ull);
+			value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+			value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+
+			return value ^ (value >> 31);
+		}
+
+		// [0, 1)
+		float NextFloat(void) noexcept
+		{
+			return static_cast<float>(Next() >> 40) * (1.0f / 16777216.0f);
+		}
+
+	private:
+		uint64_t m_state;
+	};
+
+	struct BrushCell
+	{
+		int		m_x;
+		int		m_z;
+		float	m_weight;
+	};
+
+	struct Map
+	{
+		float*	m_heights;
+		int		m_width;
+		int		m_height;
+	};
+
+	// Cells within the radius, weights fall off linearly and sum to 1
+	std::vector<BrushCell> MakeBrush(int radius)
+	{
+		std::vector<BrushCell> brush;
+		float totalWeight = 0.0f;
+
+		for (int z = -radius; z <= radius; ++z)
+		{
+			for (int x = -radius; x <= radius; ++x)
+			{
+				const float distance = std::sqrt(static_cast<float>(x * x + z * z));
+
+				if (distance >= static_cast<float>(radius) && !(x == 0 && z == 0))
+					continue;
+
+				const float weight = (radius > 0) ? 1.0f - distance / static_cast<float>(radius) : 1.0f;
+
+				brush.push_back({x, z, weight});
+				totalWeight += weight;
+			}
+		}
+
+		for (BrushCell& cell : brush)
+			cell.m_weight /= totalWeight;
+
+		return brush;
+	}
+
+	// Bilinear height and gradient, the position has to be at least one cell away from the last row / column
+	inline float HeightAndGradient(Map const& map, float x, float z, float& gradientX, float& gradientZ) noexcept
+	{
+		const int cellX = static_cast<int>(x);
+		const int cellZ = static_cast<int>(z);
+		const float u = x - static_cast<float>(cellX);
+		const float v = z - static_cast<float>(cellZ);
+
+		float const* cell = map.m_heights + static_cast<size_t>(cellZ) * map.m_width + cellX;
+
+		const float h00 = cell[0];
+		const float h10 = cell[1];
+		const float h01 = cell[map.m_width];
+		const float h11 = cell[map.m_width + 1];
+
+		gradientX = (h10 - h00) * (1.0f - v) + (h11 - h01) * v;
+		gradientZ = (h01 - h00) * (1.0f - u) + (h11 - h10) * u;
+
+		return h00 * (1.0f - u) * (1.0f - v) + h10 * u * (1.0f - v) + h01 * (1.0f - u) * v + h11 * u * v;
+	}
+
+	void SimulateDroplet(Map const& map, std::vector<BrushCell> const& brush, src::erosion::ErosionParams const& params, float x, float z)
+	{
+		float directionX = 0.0f;
+		float directionZ = 0.0f;
+		float speed = params.m_initialSpeed;
+		float water = params.m_initialWater;
+		float sediment = 0.0f;
+
+		for (unsigned int step = 0; step < params.m_maxLifetime; ++step)
+		{
+			const int cellX = static_cast<int>(x);
+			const int cellZ = static_cast<int>(z);
+			const float u = x - static_cast<float>(cellX);
+			const float v = z - static_cast<float>(cellZ);
+
+			float gradientX;
+			float gradientZ;
+			const float height = HeightAndGradient(map, x, z, gradientX, gradientZ);
+
+			// Blend the previous direction with the downhill direction, then move exactly one cell
+			directionX = directionX * params.m_inertia - gradientX * (1.0f - params.m_inertia);
+			directionZ = directionZ * params.m_inertia - gradientZ * (1.0f - params.m_inertia);
+
+			const float length = std::sqrt(directionX * directionX + directionZ * directionZ);
+
+			if (length <= 0.0f)
+				break;
+
+			directionX /= length;
+			directionZ /= length;
+			x += directionX;
+			z += directionZ;
+
+			if (x < 0.0f || z < 0.0f || x >= static_cast<float>(map.m_width - 1) || z >= static_cast<float>(map.m_height - 1))
+				break;
+
+			float unusedX;
+			float unusedZ;
+			const float deltaHeight = HeightAndGradient(map, x, z, unusedX, unusedZ) - height;
+			const float capacity = std::max(-deltaHeight * speed * water * params.m_sedimentCapacity, params.m_minSedimentCapacity);
+
+			float* cell = map.m_heights + static_cast<size_t>(cellZ) * map.m_width + cellX;
+
+			if (sediment > capacity || deltaHeight > 0.0f)
+			{
+				// Going uphill fills the pit behind, otherwise part of the excess is dropped
+				const float deposit = (deltaHeight > 0.0f) ? std::min(deltaHeight, sediment) : (sediment - capacity) * params.m_depositSpeed;
+				sediment -= deposit;
+
+				cell[0] += deposit * (1.0f - u) * (1.0f - v);
+				cell[1] += deposit * u * (1.0f - v);
+				cell[map.m_width] += deposit * (1.0f - u) * v;
+				cell[map.m_width + 1] += deposit * u * v;
+			}
+			else
+			{
+				// Never dig deeper than the drop to the next position
+				const float erode = std::min((capacity - sediment) * params.m_erodeSpeed, -deltaHeight);
+
+				for (BrushCell const& brushCell : brush)
+				{
+					const int brushX = cellX + brushCell.m_x;
+					const int brushZ = cellZ + brushCell.m_z;
+
+					if (brushX < 0 || brushZ < 0 || brushX >= map.m_width || brushZ >= map.m_height)
+						continue;
+
+					const float amount = erode * brushCell.m_weight;
+
+					map.m_heights[static_cast<size_t>(brushZ) * map.m_width + brushX] -= amount;
+					sediment += amount;
+				}
+			}
+
+			speed = std::sqrt(std::max(speed * speed - deltaHeight * params.m_gravity, 0.0f));
+			water *= 1.0f - params.m_evaporateSpeed;
+		}
+	}
+
+	void ErodePartition(Map const& map, std::vector<BrushCell> const& brush, src::erosion::ErosionParams const& params,
+						unsigned int partitionSize, unsigned int partitionX, unsigned int partitionZ)
+	{
+		// Droplets start inside the partition and away from the last row / column
+		const float minX = static_cast<float>(partitionX * partitionSize);
+		const float minZ = static_cast<float>(partitionZ * partitionSize);
+		const float maxX = std::min(minX + static_cast<float>(partitionSize), static_cast<float>(map.m_width - 1));
+		const float maxZ = std::min(minZ + static_cast<float>(partitionSize), static_cast<float>(map.m_height - 1));
+
+		if (maxX <= minX || maxZ <= minZ)
+			return;
+
+		const unsigned int dropletCount = static_cast<unsigned int>(std::lround((maxX - minX) * (maxZ - minZ) * params.m_dropletsPerCell));
+
+		// Own sequence per partition, independent of the order partitions are processed in
+		Random random((static_cast<uint64_t>(params.m_seed) << 32) ^ (static_cast<uint64_t>(partitionZ) << 16) ^ partitionX);
+		random.Next();
+
+		// A float just below 1 can still round the start onto the last row / column, clamp below it
+		const float lastX = std::nextafter(maxX, minX);
+		const float lastZ = std::nextafter(maxZ, minZ);
+
+		for (unsigned int i = 0; i < dropletCount; ++i)
+		{
+			const float x = std::min(minX + random.NextFloat() * (maxX - minX), lastX);
+			const float z = std::min(minZ + random.NextFloat() * (maxZ - minZ), lastZ);
+
+			SimulateDroplet(map, brush, params, x, z);
+		}
+	}
+
+	// Flow from a sample to a neighbour, signed excess of the height difference over the talus
+	inline float ThermalFlow(float sample, float neighbour, float talus) noexcept
+	{
+		const float difference = sample - neighbour;
+
+		return std::copysign(std::max(std::fabs(difference) - talus, 0.0f), difference);
+	}
+
+	inline float ThermalSample(float const* row, float const* up, float const* down, unsigned int x, unsigned int width, float talus, float coefficient) noexcept
+	{
+		// Neighbours outside the map are the sample itself, no flow
+		const float sample = row[x];
+		const float left = (x > 0) ? row[x - 1] : sample;
+		const float right = (x + 1 < width) ? row[x + 1] : sample;
+
+		const float flow = ThermalFlow(sample, left, talus) + ThermalFlow(sample, right, talus) +
+						   ThermalFlow(sample, up[x], talus) + ThermalFlow(sample, down[x], talus);
+
+		return flow * coefficient;
+	}
+
+	// Writes one eroded row and returns the largest change, up / down are the row itself on the map border
+	float ThermalRow(float const* row, float const* up, float const* down, float* output, unsigned int width, float talus, float coefficient, bool keepEnds) noexcept
+	{
+		float maxChange = 0.0f;
+		unsigned int x = 1;
+
+#ifdef SRC_SIMD_SSE2
+		// Same operations in the same order as the scalar path, results are identical
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 talusVec = _mm_set1_ps(talus);
+		const __m128 coefficientVec = _mm_set1_ps(coefficient);
+		__m128 maxChangeVec = zero;
+
+		auto flow = [&](__m128 sample, __m128 neighbour)
+		{
+			const __m128 difference = _mm_sub_ps(sample, neighbour);
+			const __m128 excess = _mm_max_ps(_mm_sub_ps(_mm_andnot_ps(signMask, difference), talusVec), zero);
+
+			return _mm_or_ps(excess, _mm_and_ps(difference, signMask));
+		};
+
+		for (; x + 4 < width; x += 4)
+		{
+			const __m128 sample = _mm_loadu_ps(row + x);
+
+			__m128 total = _mm_add_ps(flow(sample, _mm_loadu_ps(row + x - 1)), flow(sample, _mm_loadu_ps(row + x + 1)));
+			total = _mm_add_ps(total, flow(sample, _mm_loadu_ps(up + x)));
+			total = _mm_add_ps(total, flow(sample, _mm_loadu_ps(down + x)));
+
+			const __m128 change = _mm_mul_ps(total, coefficientVec);
+
+			_mm_storeu_ps(output + x, _mm_sub_ps(sample, change));
+			maxChangeVec = _mm_max_ps(maxChangeVec, _mm_andnot_ps(signMask, change));
+		}
+
+		float lanes[4];
+		_mm_storeu_ps(lanes, maxChangeVec);
+		maxChange = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+
+		for (; x + 1 < width; ++x)
+		{
+			const float change = ThermalSample(row, up, down, x, width, talus, coefficient);
+
+			output[x] = row[x] - change;
+			maxChange = std::max(maxChange, std::fabs(change));
+		}
+
+		// First and last samples miss a neighbour
+		for (unsigned int end : {0u, width - 1})
+		{
+			const float change = keepEnds ? 0.0f : ThermalSample(row, up, down, end, width, talus, coefficient);
+
+			output[end] = row[end] - change;
+			maxChange = std::max(maxChange, std::fabs(change));
+		}
+
+		return maxChange;
+	}
+}
+
+uint64_t src::erosion::ErosionParams::Hash(void) const noexcept
+{
+	StableHash hash;
+
+	hash.Add(m_seed).Add(m_dropletsPerCell).Add(m_maxLifetime).Add(m_radius).Add(m_inertia);
+	hash.Add(m_sedimentCapacity).Add(m_minSedimentCapacity).Add(m_erodeSpeed).Add(m_depositSpeed);
+	hash.Add(m_evaporateSpeed).Add(m_gravity).Add(m_initialWater).Add(m_initialSpeed).Add(m_partitionSize).Add(m_keepBorders);
+
+	return hash.Get();
+}
+
+uint64_t src::erosion::ThermalParams::Hash(void) const noexcept
+{
+	StableHash hash;
+
+	hash.Add(m_talusAngle).Add(m_rate).Add(m_iterations).Add(m_convergenceThreshold).Add(m_keepBorders);
+
+	return hash.Get();
+}
+
+unsigned int src::erosion::HaloSize(ErosionParams const& params) noexcept
+{
+	// One cell per step plus the brush and the bilinear footprint
+	return params.m_maxLifetime + params.m_radius + 2;
+}
+
+void src::erosion::Erode(float* heights, unsigned int width, unsigned int height, ErosionParams const& params, ThreadPool* threadPool)
+{
+	if (!heights || width < 2 || height < 2)
+		return;
+
+	const Map map{heights, static_cast<int>(width), static_cast<int>(height)};
+	const std::vector<BrushCell> brush = MakeBrush(static_cast<int>(params.m_radius));
+
+	// Droplets may cross the border, the original samples are put back afterwards
+	std::vector<float> borders;
+
+	if (params.m_keepBorders)
+	{
+		borders.reserve(2 * static_cast<size_t>(width) + 2 * static_cast<size_t>(height));
+		borders.insert(borders.end(), heights, heights + width);
+		borders.insert(borders.end(), heights + static_cast<size_t>(height - 1) * width, heights + static_cast<size_t>(height) * width);
+
+		for (unsigned int z = 0; z < height; ++z)
+		{
+			borders.push_back(heights[static_cast<size_t>(z) * width]);
+			borders.push_back(heights[static_cast<size_t>(z) * width + width - 1]);
+		}
+	}
+
+	// Partitions of a pass are one partition apart, their halos can not overlap
+	const unsigned int partitionSize = std::max(params.m_partitionSize, 2 * HaloSize(params));
+	const unsigned int partitionCountX = (width + partitionSize - 1) / partitionSize;
+	const unsigned int partitionCountZ = (height + partitionSize - 1) / partitionSize;
+
+	std::vector<unsigned int> partitions;
+
+	for (unsigned int pass = 0; pass < 4; ++pass)
+	{
+		// Partitions with the x / z parity of this pass, packed as z * countX + x
+		partitions.clear();
+
+		for (unsigned int z = pass >> 1; z < partitionCountZ; z += 2)
+		{
+			for (unsigned int x = pass & 1; x < partitionCountX; x += 2)
+				partitions.push_back(z * partitionCountX + x);
+		}
+
+		auto erodePartitions = [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				ErodePartition(map, brush, params, partitionSize, partitions[i] % partitionCountX, partitions[i] / partitionCountX);
+		};
+
+		if (threadPool)
+			threadPool->ParallelFor(partitions.size(), 1, erodePartitions);
+		else
+			erodePartitions(0, partitions.size());
+	}
+
+	if (params.m_keepBorders)
+	{
+		float const* border = borders.data();
+
+		std::memcpy(heights, border, width * sizeof(float));
+		border += width;
+		std::memcpy(heights + static_cast<size_t>(height - 1) * width, border, width * sizeof(float));
+		border += width;
+
+		for (unsigned int z = 0; z < height; ++z)
+		{
+			heights[static_cast<size_t>(z) * width] = *border++;
+			heights[static_cast<size_t>(z) * width + width - 1] = *border++;
+		}
+	}
+}
+
+void src::erosion::Erode(HeightField& field, ErosionParams const& params, ThreadPool* threadPool)
+{
+	const unsigned int samplesPerSide = field.GetSamplesPerSide();
+
+	Erode(field.GetHeights().data(), samplesPerSide, samplesPerSide, params, threadPool);
+	field.BuildPyramid();
+}
+
+unsigned int src::erosion::ErodeThermal(float* heights, unsigned int width, unsigned int height, float cellSize, ThermalParams const& params, ThreadPool* threadPool)
+{
+	if (!heights || width < 2 || height < 2 || params.m_iterations == 0)
+		return 0;
+
+	const float talus = std::tan(params.m_talusAngle * std::numbers::pi_v<float> / 180.0f) * cellSize;
+
+	// A pair moving half its excess would meet at the talus, each sample has up to 4 pairs
+	const float coefficient = std::clamp(params.m_rate, 0.0f, 1.0f) * 0.125f;
+
+	const size_t sampleCount = static_cast<size_t>(width) * height;
+	std::vector<float> scratch(sampleCount);
+	std::vector<float> rowChanges(height, 0.0f);
+
+	float* source = heights;
+	float* target = scratch.data();
+	unsigned int iteration = 0;
+
+	while (iteration < params.m_iterations)
+	{
+		auto erodeRows = [&](size_t begin, size_t end)
+		{
+			for (size_t z = begin; z < end; ++z)
+			{
+				float const* row = source + z * width;
+				float* output = target + z * width;
+
+				if (params.m_keepBorders && (z == 0 || z + 1 == height))
+				{
+					std::memcpy(output, row, width * sizeof(float));
+					rowChanges[z] = 0.0f;
+					continue;
+				}
+
+				float const* up = (z > 0) ? row - width : row;
+				float const* down = (z + 1 < height) ? row + width : row;
+
+				rowChanges[z] = ThermalRow(row, up, down, output, width, talus, coefficient, params.m_keepBorders);
+			}
+		};
+
+		if (threadPool)
+			threadPool->ParallelFor(height, g_thermalGrainSize, erodeRows);
+		else
+			erodeRows(0, height);
+
+		std::swap(source, target);
+		++iteration;
+
+		if (params.m_convergenceThreshold > 0.0f && *std::max_element(rowChanges.begin(), rowChanges.end()) < params.m_convergenceThreshold)
+			break;
+	}
+
+	if (source != heights)
+		std::memcpy(heights, source, sampleCount * sizeof(float));
+
+	return iteration;
+}
+
+unsigned int src::erosion::ErodeThermal(HeightField& field, ThermalParams const& params, ThreadPool* threadPool)
+{
+	const unsigned int samplesPerSide = field.GetSamplesPerSide();
+	const unsigned int iterations = ErodeThermal(field.GetHeights().data(), samplesPerSide, samplesPerSide, field.GetCellSize(), params, threadPool);
+
+	field.BuildPyramid();
+
+	return iterations;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+
+namespace src
+{
+	class HeightField;
+	class ThreadPool;
+}
+
+/*
+*	Particle (droplet) hydraulic erosion
+*
+*	Droplets flow down the gradient, pick up sediment while they speed up and deposit it when
+*	they slow down or overflow their capacity. The map is split in square partitions, each
+*	simulating its own droplets with its own random sequence. A droplet never travels further
+*	than its lifetime, so its reads and writes stay within the partition plus a halo of
+*	HaloSize cells. Partitions are processed in four passes (by x / z parity) and partitions
+*	of one pass are at least two halos apart, they run in parallel without touching the same
+*	cells. Results only depend on the seed, never on the thread count or scheduling.
+*
+*	Thermal erosion moves material from samples steeper than the talus angle to their four
+*	neighbours. Every sample gathers the flows with its neighbours from the previous iteration's
+*	heights (double buffered), so rows are independent and vectorize, flows between two samples
+*	are symmetric and the total height is preserved.
+*/
+namespace src::erosion
+{
+	struct ErosionParams
+	{
+		uint32_t		m_seed = 0;
+		float			m_dropletsPerCell = 0.1f;
+		unsigned int	m_maxLifetime = 30;			// Steps per droplet, each step moves one cell
+		unsigned int	m_radius = 3;				// Cells eroded around a droplet
+		float			m_inertia = 0.05f;			// How much a droplet keeps its direction, 0 - 1
+		float			m_sedimentCapacity = 4.0f;
+		float			m_minSedimentCapacity = 0.01f;
+		float			m_erodeSpeed = 0.3f;
+		float			m_depositSpeed = 0.3f;
+		float			m_evaporateSpeed = 0.01f;
+		float			m_gravity = 4.0f;
+		float			m_initialWater = 1.0f;
+		float			m_initialSpeed = 1.0f;
+		unsigned int	m_partitionSize = 128;		// Cells per partition side, raised to 2 * HaloSize if smaller
+		bool			m_keepBorders = false;		// Border samples keep their height so independently eroded tiles still match
+
+		// Same value on every platform, identifies eroded tiles
+		uint64_t Hash(void) const noexcept;
+	};
+
+	struct ThermalParams
+	{
+		float			m_talusAngle = 35.0f;		// Degrees, steeper slopes collapse
+		float			m_rate = 0.5f;				// Fraction of the excess height difference removed per iteration, 0 - 1
+		unsigned int	m_iterations = 50;			// Upper bound
+		float			m_convergenceThreshold = 0.0f; // Stops once no sample moves more than this, 0 always runs every iteration
+		bool			m_keepBorders = false;		// Border samples keep their height so independently eroded tiles still match
+
+		// Same value on every platform, identifies eroded tiles
+		uint64_t Hash(void) const noexcept;
+	};
+
+	// Cells around a partition a droplet started in can read or write
+	unsigned int HaloSize(ErosionParams const& params) noexcept;
+
+	// Row major heights (x varies fastest), null thread pool runs on the calling thread
+	void Erode(float* heights, unsigned int width, unsigned int height, ErosionParams const& params, ThreadPool* threadPool);
+
+	// Erodes every sample then rebuilds the field's pyramid, normals have to be recomputed if used
+	void Erode(HeightField& field, ErosionParams const& params, ThreadPool* threadPool);
+
+	// Returns the number of iterations run, cellSize is the distance between two samples
+	unsigned int ErodeThermal(float* heights, unsigned int width, unsigned int height, float cellSize, ThermalParams const& params, ThreadPool* threadPool);
+	unsigned int ErodeThermal(HeightField& field, ThermalParams const& params, ThreadPool* threadPool);
+}
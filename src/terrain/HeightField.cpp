@@ -0,0 +1,452 @@
+#include "terrain/HeightField.h"
+#include "utility/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	constexpr float g_infinity = std::numeric_limits<float>::infinity();
+
+	// Large enough for 4 children per level on a 2^20 cell wide field
+	constexpr int g_maxStackSize = 128;
+
+	// Number of rays processed per thread pool chunk
+	constexpr size_t g_raycastGrainSize = 256;
+
+	struct TraversalNode
+	{
+		unsigned int	m_level;
+		unsigned int	m_x;
+		unsigned int	m_z;
+		float			m_tEnter;
+	};
+
+	// Slab test, returns the parametric range the ray spends inside the box
+	inline bool IntersectBox(float const origin[3], float const invDirection[3], float const boxMin[3], float const boxMax[3], float& tEnter, float& tExit) noexcept
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			float t0 = (boxMin[axis] - origin[axis]) * invDirection[axis];
+			float t1 = (boxMax[axis] - origin[axis]) * invDirection[axis];
+
+			if (t0 > t1)
+				std::swap(t0, t1);
+
+			// NaN (0 * inf) means the ray lies on the slab plane, treat as inside
+			if (t0 == t0)
+				tEnter = std::max(tEnter, t0);
+			if (t1 == t1)
+				tExit = std::min(tExit, t1);
+		}
+
+		return tEnter <= tExit;
+	}
+
+	// Möller–Trumbore without back face culling
+	inline bool IntersectTriangle(float const origin[3], float const direction[3], float const v0[3], float const v1[3], float const v2[3], float& distance) noexcept
+	{
+		constexpr float epsilon = 1e-7f;
+
+		const float edge1[3] = {v1[0] - v0[0], v1[1] - v0[1], v1[2] - v0[2]};
+		const float edge2[3] = {v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2]};
+
+		const float pVec[3] =
+		{
+			direction[1] * edge2[2] - direction[2] * edge2[1],
+			direction[2] * edge2[0] - direction[0] * edge2[2],
+			direction[0] * edge2[1] - direction[1] * edge2[0]
+		};
+
+		const float determinant = edge1[0] * pVec[0] + edge1[1] * pVec[1] + edge1[2] * pVec[2];
+
+		if (std::fabs(determinant) < epsilon)
+			return false;
+
+		const float invDeterminant = 1.0f / determinant;
+		const float tVec[3] = {origin[0] - v0[0], origin[1] - v0[1], origin[2] - v0[2]};
+
+		const float u = (tVec[0] * pVec[0] + tVec[1] * pVec[1] + tVec[2] * pVec[2]) * invDeterminant;
+
+		if (u < 0.0f || u > 1.0f)
+			return false;
+
+		const float qVec[3] =
+		{
+			tVec[1] * edge1[2] - tVec[2] * edge1[1],
+			tVec[2] * edge1[0] - tVec[0] * edge1[2],
+			tVec[0] * edge1[1] - tVec[1] * edge1[0]
+		};
+
+		const float v = (direction[0] * qVec[0] + direction[1] * qVec[1] + direction[2] * qVec[2]) * invDeterminant;
+
+		if (v < 0.0f || u + v > 1.0f)
+			return false;
+
+		distance = (edge2[0] * qVec[0] + edge2[1] * qVec[1] + edge2[2] * qVec[2]) * invDeterminant;
+
+		return distance >= 0.0f;
+	}
+}
+
+src::HeightField::HeightField(math::Vector2<float> origin, float cellSize, unsigned int resolution)
+	: m_origin(origin), m_cellSize(cellSize), m_resolution(resolution)
+{
+	m_heights.resize(static_cast<size_t>(resolution + 1) * (resolution + 1), 0.0f);
+}
+
+void src::HeightField::Generate(noise::NoiseParams const& params)
+{
+	Generate(params, noise::MakeNoiseOrigin(static_cast<double>(m_origin[0]), static_cast<double>(m_origin[1]), params));
+}
+
+void src::HeightField::Generate(noise::NoiseParams const& params, noise::NoiseOrigin const& noiseOrigin)
+{
+	const unsigned int samplesPerSide = GetSamplesPerSide();
+
+	// Rows are sampled in batches (SIMD), x offsets are the same for every row
+	std::vector<float> localX(samplesPerSide);
+	std::vector<float> localZ(samplesPerSide);
+
+	for (unsigned int x = 0; x < samplesPerSide; ++x)
+		localX[x] = static_cast<float>(x) * m_cellSize;
+
+	for (unsigned int z = 0; z < samplesPerSide; ++z)
+	{
+		std::fill(localZ.begin(), localZ.end(), static_cast<float>(z) * m_cellSize);
+		float* row = m_heights.data() + static_cast<size_t>(z) * samplesPerSide;
+
+		noise::SampleHeights(noiseOrigin, localX.data(), localZ.data(), row, samplesPerSide, params);
+	}
+
+	BuildPyramid();
+	ComputeNormals();
+}
+
+void src::HeightField::BuildPyramid(void)
+{
+	m_pyramid.clear();
+
+	if (m_resolution == 0)
+		return;
+
+	const unsigned int samplesPerSide = GetSamplesPerSide();
+
+	// Level 0, bounds of the 4 corners of each cell
+	PyramidLevel base;
+	base.m_width = m_resolution;
+	base.m_cells.resize(static_cast<size_t>(m_resolution) * m_resolution);
+
+	for (unsigned int z = 0; z < m_resolution; ++z)
+	{
+		const float* row0 = m_heights.data() + static_cast<size_t>(z) * samplesPerSide;
+		const float* row1 = row0 + samplesPerSide;
+
+		for (unsigned int x = 0; x < m_resolution; ++x)
+		{
+			MinMax& cell = base.m_cells[static_cast<size_t>(z) * m_resolution + x];
+
+			cell.m_min = std::min(std::min(row0[x], row0[x + 1]), std::min(row1[x], row1[x + 1]));
+			cell.m_max = std::max(std::max(row0[x], row0[x + 1]), std::max(row1[x], row1[x + 1]));
+		}
+	}
+
+	m_pyramid.push_back(std::move(base));
+
+	// Reduce 2x2 blocks until a single node covers the whole field
+	while (m_pyramid.back().m_width > 1)
+	{
+		PyramidLevel const& child = m_pyramid.back();
+
+		PyramidLevel parent;
+		parent.m_width = (child.m_width + 1) / 2;
+		parent.m_cells.resize(static_cast<size_t>(parent.m_width) * parent.m_width);
+
+		for (unsigned int z = 0; z < parent.m_width; ++z)
+		{
+			for (unsigned int x = 0; x < parent.m_width; ++x)
+			{
+				MinMax bounds = {g_infinity, -g_infinity};
+
+				for (unsigned int childZ = z * 2; childZ < std::min(z * 2 + 2, child.m_width); ++childZ)
+				{
+					for (unsigned int childX = x * 2; childX < std::min(x * 2 + 2, child.m_width); ++childX)
+					{
+						MinMax const& childBounds = child.m_cells[static_cast<size_t>(childZ) * child.m_width + childX];
+
+						bounds.m_min = std::min(bounds.m_min, childBounds.m_min);
+						bounds.m_max = std::max(bounds.m_max, childBounds.m_max);
+					}
+				}
+
+				parent.m_cells[static_cast<size_t>(z) * parent.m_width + x] = bounds;
+			}
+		}
+
+		m_pyramid.push_back(std::move(parent));
+	}
+}
+
+void src::HeightField::ComputeNormals(void)
+{
+	const unsigned int samplesPerSide = GetSamplesPerSide();
+	m_normals.resize(m_heights.size());
+
+	if (m_resolution == 0)
+		return;
+
+	// Central differences, falling back to one sided differences on the borders
+	for (unsigned int z = 0; z < samplesPerSide; ++z)
+	{
+		const unsigned int z0 = (z > 0) ? z - 1 : z;
+		const unsigned int z1 = (z < m_resolution) ? z + 1 : z;
+
+		for (unsigned int x = 0; x < samplesPerSide; ++x)
+		{
+			const unsigned int x0 = (x > 0) ? x - 1 : x;
+			const unsigned int x1 = (x < m_resolution) ? x + 1 : x;
+
+			const float slopeX = (GetHeight(x1, z) - GetHeight(x0, z)) / (static_cast<float>(x1 - x0) * m_cellSize);
+			const float slopeZ = (GetHeight(x, z1) - GetHeight(x, z0)) / (static_cast<float>(z1 - z0) * m_cellSize);
+
+			m_normals[static_cast<size_t>(z) * samplesPerSide + x] = math::Vector3<float>(-slopeX, 1.0f, -slopeZ).Normalize();
+		}
+	}
+}
+
+bool src::HeightField::Raycast(Ray const& ray, float maxDistance, RayHit& hit) const
+{
+	hit.m_hit = false;
+
+	if (m_pyramid.empty())
+		return false;
+
+	const float origin[3] = {ray.m_origin[0], ray.m_origin[1], ray.m_origin[2]};
+	const float direction[3] = {ray.m_direction[0], ray.m_direction[1], ray.m_direction[2]};
+	const float invDirection[3] =
+	{
+		(direction[0] != 0.0f) ? 1.0f / direction[0] : g_infinity,
+		(direction[1] != 0.0f) ? 1.0f / direction[1] : g_infinity,
+		(direction[2] != 0.0f) ? 1.0f / direction[2] : g_infinity
+	};
+
+	const float fieldMaxX = m_origin[0] + static_cast<float>(m_resolution) * m_cellSize;
+	const float fieldMaxZ = m_origin[1] + static_cast<float>(m_resolution) * m_cellSize;
+
+	float closest = maxDistance;
+
+	TraversalNode stack[g_maxStackSize];
+	int stackSize = 0;
+
+	stack[stackSize++] = {static_cast<unsigned int>(m_pyramid.size() - 1), 0, 0, 0.0f};
+
+	while (stackSize > 0)
+	{
+		const TraversalNode node = stack[--stackSize];
+
+		// A closer hit was found after this node was pushed
+		if (node.m_tEnter > closest)
+			continue;
+
+		if (node.m_level == 0)
+		{
+			float distance;
+
+			if (IntersectCell(node.m_x, node.m_z, origin, direction, distance) && distance <= closest)
+			{
+				closest = distance;
+				hit.m_hit = true;
+			}
+
+			continue;
+		}
+
+		// Test children and visit the nearest first so far ones can be culled by 'closest'
+		PyramidLevel const& childLevel = m_pyramid[node.m_level - 1];
+		const float childSpan = m_cellSize * static_cast<float>(1u << (node.m_level - 1));
+
+		TraversalNode children[4];
+		int childCount = 0;
+
+		for (unsigned int childZ = node.m_z * 2; childZ < std::min(node.m_z * 2 + 2, childLevel.m_width); ++childZ)
+		{
+			for (unsigned int childX = node.m_x * 2; childX < std::min(node.m_x * 2 + 2, childLevel.m_width); ++childX)
+			{
+				MinMax const& bounds = childLevel.m_cells[static_cast<size_t>(childZ) * childLevel.m_width + childX];
+
+				const float boxMin[3] =
+				{
+					m_origin[0] + static_cast<float>(childX) * childSpan,
+					bounds.m_min,
+					m_origin[1] + static_cast<float>(childZ) * childSpan
+				};
+
+				const float boxMax[3] =
+				{
+					std::min(boxMin[0] + childSpan, fieldMaxX),
+					bounds.m_max,
+					std::min(boxMin[2] + childSpan, fieldMaxZ)
+				};
+
+				float tEnter = 0.0f;
+				float tExit = closest;
+
+				if (IntersectBox(origin, invDirection, boxMin, boxMax, tEnter, tExit))
+					children[childCount++] = {node.m_level - 1, childX, childZ, tEnter};
+			}
+		}
+
+		std::sort(children, children + childCount, [](TraversalNode const& lhs, TraversalNode const& rhs)
+		{
+			return lhs.m_tEnter > rhs.m_tEnter;
+		});
+
+		for (int i = 0; i < childCount && stackSize < g_maxStackSize; ++i)
+			stack[stackSize++] = children[i];
+	}
+
+	if (hit.m_hit)
+	{
+		hit.m_distance = closest;
+		hit.m_position = ray.m_origin + ray.m_direction * closest;
+	}
+
+	return hit.m_hit;
+}
+
+void src::HeightField::RaycastBatch(Ray const* rays, RayHit* hits, size_t rayCount, float maxDistance, ThreadPool& threadPool) const
+{
+	threadPool.ParallelFor(rayCount, g_raycastGrainSize, [this, rays, hits, maxDistance](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+			Raycast(rays[i], maxDistance, hits[i]);
+	});
+}
+
+bool src::HeightField::HasLineOfSight(math::Vector3<float> const& from, math::Vector3<float> const& to) const
+{
+	math::Vector3<float> direction = to - from;
+	const float distance = direction.Magnitude();
+
+	if (distance <= 0.0f)
+		return true;
+
+	RayHit hit;
+	return !Raycast(Ray(from, direction / distance), distance, hit);
+}
+
+float src::HeightField::GetHeight(unsigned int x, unsigned int z) const noexcept
+{
+	return m_heights[static_cast<size_t>(z) * GetSamplesPerSide() + x];
+}
+
+float src::HeightField::SampleHeight(float worldX, float worldZ) const noexcept
+{
+	if (m_resolution == 0)
+		return 0.0f;
+
+	// Clamp to the field then bilinearly interpolate the surrounding samples
+	const float maxCoord = static_cast<float>(m_resolution);
+	const float localX = std::clamp((worldX - m_origin[0]) / m_cellSize, 0.0f, maxCoord);
+	const float localZ = std::clamp((worldZ - m_origin[1]) / m_cellSize, 0.0f, maxCoord);
+
+	const unsigned int cellX = std::min(static_cast<unsigned int>(localX), m_resolution - 1);
+	const unsigned int cellZ = std::min(static_cast<unsigned int>(localZ), m_resolution - 1);
+	const float fracX = localX - static_cast<float>(cellX);
+	const float fracZ = localZ - static_cast<float>(cellZ);
+
+	const float h00 = GetHeight(cellX, cellZ);
+	const float h10 = GetHeight(cellX + 1, cellZ);
+	const float h01 = GetHeight(cellX, cellZ + 1);
+	const float h11 = GetHeight(cellX + 1, cellZ + 1);
+
+	const float bottom = h00 + (h10 - h00) * fracX;
+	const float top = h01 + (h11 - h01) * fracX;
+
+	return bottom + (top - bottom) * fracZ;
+}
+
+src::HeightField::MinMax src::HeightField::GetBounds(void) const noexcept
+{
+	return m_pyramid.empty() ? MinMax{0.0f, 0.0f} : m_pyramid.back().m_cells[0];
+}
+
+math::Vector3<float> src::HeightField::GetNormal(unsigned int x, unsigned int z) const noexcept
+{
+	return m_normals.empty() ? math::Vector3<float>::Up() : m_normals[static_cast<size_t>(z) * GetSamplesPerSide() + x];
+}
+
+size_t src::HeightField::GetByteSize(void) const noexcept
+{
+	size_t byteSize = sizeof(HeightField);
+
+	byteSize += m_heights.capacity() * sizeof(float);
+	byteSize += m_normals.capacity() * sizeof(math::Vector3<float>);
+
+	for (PyramidLevel const& level : m_pyramid)
+		byteSize += sizeof(PyramidLevel) + level.m_cells.capacity() * sizeof(MinMax);
+
+	return byteSize;
+}
+
+math::Vector2<float> src::HeightField::GetOrigin(void) const noexcept
+{
+	return m_origin;
+}
+
+float src::HeightField::GetCellSize(void) const noexcept
+{
+	return m_cellSize;
+}
+
+unsigned int src::HeightField::GetResolution(void) const noexcept
+{
+	return m_resolution;
+}
+
+unsigned int src::HeightField::GetSamplesPerSide(void) const noexcept
+{
+	return m_resolution + 1;
+}
+
+unsigned int src::HeightField::GetLevelCount(void) const noexcept
+{
+	return static_cast<unsigned int>(m_pyramid.size());
+}
+
+std::vector<float>& src::HeightField::GetHeights(void) noexcept
+{
+	return m_heights;
+}
+
+std::vector<float> const& src::HeightField::GetHeights(void) const noexcept
+{
+	return m_heights;
+}
+
+bool src::HeightField::IntersectCell(unsigned int cellX, unsigned int cellZ, float const origin[3], float const direction[3], float& distance) const
+{
+	const float x0 = m_origin[0] + static_cast<float>(cellX) * m_cellSize;
+	const float z0 = m_origin[1] + static_cast<float>(cellZ) * m_cellSize;
+	const float x1 = x0 + m_cellSize;
+	const float z1 = z0 + m_cellSize;
+
+	const float p00[3] = {x0, GetHeight(cellX, cellZ), z0};
+	const float p10[3] = {x1, GetHeight(cellX + 1, cellZ), z0};
+	const float p11[3] = {x1, GetHeight(cellX + 1, cellZ + 1), z1};
+	const float p01[3] = {x0, GetHeight(cellX, cellZ + 1), z1};
+
+	// Cell is split into 2 triangles along the p00 - p11 diagonal
+	float distance0 = g_infinity;
+	float distance1 = g_infinity;
+
+	const bool hit0 = IntersectTriangle(origin, direction, p00, p10, p11, distance0);
+	const bool hit1 = IntersectTriangle(origin, direction, p00, p11, p01, distance1);
+
+	if (!hit0 && !hit1)
+		return false;
+
+	distance = std::min(hit0 ? distance0 : g_infinity, hit1 ? distance1 : g_infinity);
+	return true;
+}
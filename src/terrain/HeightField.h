@@ -0,0 +1,75 @@
+#pragma once
+
+#include "terrain/Noise.h"
+#include "utility/Ray.h"
+
+#include "LibMath/vector/Vector2.h"
+#include "LibMath/vector/Vector3.h"
+
+#include <vector>
+
+namespace src
+{
+	class ThreadPool;
+
+	/*
+	*	CPU representation of a square terrain area. Heights are stored per grid vertex
+	*	(resolution + 1 samples per side) and a min/max mip pyramid is built over the cells
+	*	so rays can skip large empty areas instead of walking every cell.
+	*/
+	class HeightField
+	{
+	public:
+		struct MinMax
+		{
+			float m_min;
+			float m_max;
+		};
+
+		HeightField(void) = default;
+		HeightField(math::Vector2<float> origin, float cellSize, unsigned int resolution);
+		~HeightField(void) = default;
+
+		// Fill heights using the same fractal noise as Terrain.tese then rebuild the pyramid
+		void Generate(noise::NoiseParams const& params);
+
+		// Same, the noise is sampled relative to 'noiseOrigin' (world position of the first sample)
+		void Generate(noise::NoiseParams const& params, noise::NoiseOrigin const& noiseOrigin);
+		void BuildPyramid(void);
+		void ComputeNormals(void);
+
+		bool Raycast(Ray const& ray, float maxDistance, RayHit& hit) const;
+		void RaycastBatch(Ray const* rays, RayHit* hits, size_t rayCount, float maxDistance, ThreadPool& threadPool) const;
+		bool HasLineOfSight(math::Vector3<float> const& from, math::Vector3<float> const& to) const;
+
+		float GetHeight(unsigned int x, unsigned int z) const noexcept;
+		float SampleHeight(float worldX, float worldZ) const noexcept;
+		MinMax GetBounds(void) const noexcept;
+		math::Vector3<float> GetNormal(unsigned int x, unsigned int z) const noexcept;
+		size_t GetByteSize(void) const noexcept;
+
+		math::Vector2<float>	GetOrigin(void) const noexcept;
+		float					GetCellSize(void) const noexcept;
+		unsigned int			GetResolution(void) const noexcept;
+		unsigned int			GetSamplesPerSide(void) const noexcept;
+		unsigned int			GetLevelCount(void) const noexcept;
+		std::vector<float>&			GetHeights(void) noexcept;
+		std::vector<float> const&	GetHeights(void) const noexcept;
+
+	private:
+		struct PyramidLevel
+		{
+			unsigned int		m_width;
+			std::vector<MinMax>	m_cells;
+		};
+
+		bool IntersectCell(unsigned int cellX, unsigned int cellZ, float const origin[3], float const direction[3], float& distance) const;
+
+		math::Vector2<float>		m_origin;
+		float						m_cellSize = 1.0f;
+		unsigned int				m_resolution = 0;
+		std::vector<float>			m_heights; // Row major, x varies fastest
+		std::vector<math::Vector3<float>>	m_normals; // Same layout as heights, empty until computed
+		std::vector<PyramidLevel>	m_pyramid; // Level 0 holds one entry per cell, last level a single entry
+	};
+}
@@ -0,0 +1,548 @@
+#include "terrain/Noise.h"
+#include "utility/Hash.h"
+#include "utility/Simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Skew / unskew factors between the square and the simplex grid, (sqrt(3) - 1) / 2 and (3 - sqrt(3)) / 6
+	constexpr double g_simplexSkew = 0.36602540378443864676;
+	constexpr float g_simplexSkewF = 0.366025403784f;
+	constexpr float g_simplexUnskew = 0.211324865405f;
+
+	// Brings the sum of the corner contributions back to about -1 - 1
+	constexpr float g_simplexScale = 70.0f;
+
+	// Cells wrap at 2^32, the hash only sees the low 32 bits
+	constexpr double g_cellWrap = 4294967296.0;
+
+	constexpr src::noise::NoiseOrigin g_worldOrigin{};
+
+	// Part of the parameters hash, bumped when the same parameters produce different heights (baked tiles)
+	constexpr uint32_t g_algorithmVersion = 2;
+
+	inline uint32_t SeedMix(uint32_t seed) noexcept
+	{
+		return seed * 0x9E3779B9u;
+	}
+
+	inline int OctaveCount(src::noise::NoiseParams const& params) noexcept
+	{
+		return std::clamp(params.m_octaves, 0, src::noise::s_maxOctaves);
+	}
+
+	/*
+	*	Lane operations, every noise function below is written once over float and __m128 so
+	*	the scalar and SIMD paths perform the same operations in the same order. Lattice cells
+	*	are 32 bit integers (Int) hashed with wrapping integer arithmetic.
+	*/
+	template <typename T>
+	struct Lanes;
+
+	template <>
+	struct Lanes<float>
+	{
+		using Int = uint32_t;
+
+		static float Set(float value) noexcept { return value; }
+		static float Add(float lhs, float rhs) noexcept { return lhs + rhs; }
+		static float Sub(float lhs, float rhs) noexcept { return lhs - rhs; }
+		static float Mul(float lhs, float rhs) noexcept { return lhs * rhs; }
+		static float Min(float lhs, float rhs) noexcept { return (lhs < rhs) ? lhs : rhs; }
+		static float Max(float lhs, float rhs) noexcept { return (lhs > rhs) ? lhs : rhs; }
+		static float Abs(float value) noexcept { return std::fabs(value); }
+		static float Greater(float lhs, float rhs) noexcept { return (lhs > rhs) ? 1.0f : 0.0f; }
+
+		// Valid while |value| < 2^31, like the SIMD version
+		static float Floor(float value) noexcept
+		{
+			const float truncated = static_cast<float>(static_cast<int>(value));
+
+			return truncated - ((truncated > value) ? 1.0f : 0.0f);
+		}
+
+		static Int SetInt(uint32_t value) noexcept { return value; }
+		static Int AddInt(Int lhs, Int rhs) noexcept { return lhs + rhs; }
+		static Int XorInt(Int lhs, Int rhs) noexcept { return lhs ^ rhs; }
+
+		// Whole number float to wrapped integer
+		static Int ToInt(float value) noexcept { return static_cast<uint32_t>(static_cast<int32_t>(value)); }
+
+		// Low bias 32 bit integer mixer (lowbias32, Wellons)
+		static Int Mix(Int value) noexcept
+		{
+			value ^= value >> 16;
+			value *= 0x7FEB352Du;
+			value ^= value >> 15;
+			value *= 0x846CA68Bu;
+			value ^= value >> 16;
+
+			return value;
+		}
+
+		// Top 24 bits as 0 - 1
+		static float Unit(Int hash) noexcept
+		{
+			return static_cast<float>(static_cast<int32_t>(hash >> 8)) * (1.0f / 16777216.0f);
+		}
+
+		// Both 16 bit halves as 0 - 1
+		static void UnitHalves(Int hash, float& low, float& high) noexcept
+		{
+			low = static_cast<float>(static_cast<int32_t>(hash & 0xFFFFu)) * (1.0f / 65536.0f);
+			high = static_cast<float>(static_cast<int32_t>(hash >> 16)) * (1.0f / 65536.0f);
+		}
+	};
+
+#ifdef SRC_SIMD_SSE2
+	// Register wrapper, __m128 itself as a template argument loses its alignment attributes (-Wignored-attributes)
+	struct Float4
+	{
+		__m128 m_value;
+	};
+
+	template <>
+	struct Lanes<Float4>
+	{
+		using Int = __m128i;
+
+		static Float4 Set(float value) noexcept { return {_mm_set1_ps(value)}; }
+		static Float4 Add(Float4 lhs, Float4 rhs) noexcept { return {_mm_add_ps(lhs.m_value, rhs.m_value)}; }
+		static Float4 Sub(Float4 lhs, Float4 rhs) noexcept { return {_mm_sub_ps(lhs.m_value, rhs.m_value)}; }
+		static Float4 Mul(Float4 lhs, Float4 rhs) noexcept { return {_mm_mul_ps(lhs.m_value, rhs.m_value)}; }
+		static Float4 Min(Float4 lhs, Float4 rhs) noexcept { return {_mm_min_ps(lhs.m_value, rhs.m_value)}; }
+		static Float4 Max(Float4 lhs, Float4 rhs) noexcept { return {_mm_max_ps(lhs.m_value, rhs.m_value)}; }
+		static Float4 Abs(Float4 value) noexcept { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), value.m_value)}; }
+		static Float4 Greater(Float4 lhs, Float4 rhs) noexcept { return {_mm_and_ps(_mm_cmpgt_ps(lhs.m_value, rhs.m_value), _mm_set1_ps(1.0f))}; }
+
+		// SSE2 has no floor, truncate then step down where truncation rounded up
+		static Float4 Floor(Float4 value) noexcept
+		{
+			const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value.m_value));
+
+			return {_mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, value.m_value), _mm_set1_ps(1.0f)))};
+		}
+
+		static Int SetInt(uint32_t value) noexcept { return _mm_set1_epi32(static_cast<int>(value)); }
+		static Int AddInt(Int lhs, Int rhs) noexcept { return _mm_add_epi32(lhs, rhs); }
+		static Int XorInt(Int lhs, Int rhs) noexcept { return _mm_xor_si128(lhs, rhs); }
+		static Int ToInt(Float4 value) noexcept { return _mm_cvttps_epi32(value.m_value); }
+
+		// Low 32 bits of the products, _mm_mullo_epi32 is SSE4.1
+		static Int MulInt(Int lhs, Int rhs) noexcept
+		{
+			const __m128i even = _mm_mul_epu32(lhs, rhs);
+			const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(lhs, 32), _mm_srli_epi64(rhs, 32));
+
+			return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+		}
+
+		static Int Mix(Int value) noexcept
+		{
+			value = _mm_xor_si128(value, _mm_srli_epi32(value, 16));
+			value = MulInt(value, SetInt(0x7FEB352Du));
+			value = _mm_xor_si128(value, _mm_srli_epi32(value, 15));
+			value = MulInt(value, SetInt(0x846CA68Bu));
+			value = _mm_xor_si128(value, _mm_srli_epi32(value, 16));
+
+			return value;
+		}
+
+		static Float4 Unit(Int hash) noexcept
+		{
+			return {_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(hash, 8)), _mm_set1_ps(1.0f / 16777216.0f))};
+		}
+
+		static void UnitHalves(Int hash, Float4& low, Float4& high) noexcept
+		{
+			low.m_value = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(hash, _mm_set1_epi32(0xFFFF))), _mm_set1_ps(1.0f / 65536.0f));
+			high.m_value = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(hash, 16)), _mm_set1_ps(1.0f / 65536.0f));
+		}
+	};
+#endif
+
+	// Sum of every octave's amplitude, the upper bound of each variant
+	inline float MaxAmplitude(src::noise::NoiseParams const& params) noexcept
+	{
+		const int octaveCount = OctaveCount(params);
+		float total = 0.0f;
+		float amplitude = 1.0f;
+
+		for (int i = 0; i < octaveCount; ++i)
+		{
+			total += amplitude;
+			amplitude *= params.m_persistence;
+		}
+
+		return total;
+	}
+
+	inline src::noise::OctaveOrigin MakeOctaveOrigin(double x, double z) noexcept
+	{
+		const double floorX = std::floor(x);
+		const double floorZ = std::floor(z);
+
+		src::noise::OctaveOrigin origin;
+		origin.m_cellX = static_cast<uint32_t>(static_cast<int64_t>(std::fmod(floorX, g_cellWrap)));
+		origin.m_cellZ = static_cast<uint32_t>(static_cast<int64_t>(std::fmod(floorZ, g_cellWrap)));
+		origin.m_offsetX = static_cast<float>(x - floorX);
+		origin.m_offsetZ = static_cast<float>(z - floorZ);
+
+		return origin;
+	}
+
+	template <typename T>
+	typename Lanes<T>::Int HashBits(typename Lanes<T>::Int x, typename Lanes<T>::Int z, uint32_t seed) noexcept
+	{
+		using L = Lanes<T>;
+
+		return L::Mix(L::XorInt(x, L::Mix(L::AddInt(z, L::SetInt(SeedMix(seed))))));
+	}
+
+	// Lattice cell of 'position' (relative to the origin's cell) and the position inside it
+	template <typename T>
+	typename Lanes<T>::Int Cell(T position, uint32_t originCell, T& cellPosition) noexcept
+	{
+		using L = Lanes<T>;
+
+		const T floorPosition = L::Floor(position);
+		cellPosition = L::Sub(position, floorPosition);
+
+		return L::AddInt(L::SetInt(originCell), L::ToInt(floorPosition));
+	}
+
+	template <typename T>
+	T PerlinLanes(T x, T z, src::noise::OctaveOrigin const& origin, uint32_t seed) noexcept
+	{
+		using L = Lanes<T>;
+		using Int = typename L::Int;
+
+		T cellX, cellZ;
+		const Int latticeX = Cell(L::Add(x, L::Set(origin.m_offsetX)), origin.m_cellX, cellX);
+		const Int latticeZ = Cell(L::Add(z, L::Set(origin.m_offsetZ)), origin.m_cellZ, cellZ);
+		const Int latticeX1 = L::AddInt(latticeX, L::SetInt(1));
+		const Int latticeZ1 = L::AddInt(latticeZ, L::SetInt(1));
+		const T one = L::Set(1.0f);
+
+		const T llCorner = L::Unit(HashBits<T>(latticeX, latticeZ, seed));		// Lower left corner
+		const T lrCorner = L::Unit(HashBits<T>(latticeX1, latticeZ, seed));		// Lower right corner
+		const T ulCorner = L::Unit(HashBits<T>(latticeX, latticeZ1, seed));		// Upper left corner
+		const T urCorner = L::Unit(HashBits<T>(latticeX1, latticeZ1, seed));	// Upper right corner
+
+		// Smoothstep
+		const T valX = L::Mul(L::Mul(cellX, cellX), L::Sub(L::Set(3.0f), L::Mul(L::Set(2.0f), cellX)));
+		const T valZ = L::Mul(L::Mul(cellZ, cellZ), L::Sub(L::Set(3.0f), L::Mul(L::Set(2.0f), cellZ)));
+
+		T result = L::Add(llCorner, L::Mul(L::Sub(lrCorner, llCorner), valX));
+		result = L::Add(result, L::Mul(L::Mul(L::Sub(ulCorner, llCorner), valZ), L::Sub(one, valX)));
+
+		return L::Add(result, L::Mul(L::Mul(L::Sub(urCorner, lrCorner), valX), valZ));
+	}
+
+	// Contribution of one simplex corner, both gradient components come from one hash
+	template <typename T>
+	T SimplexCorner(typename Lanes<T>::Int cornerX, typename Lanes<T>::Int cornerZ, T offsetX, T offsetZ, uint32_t seed) noexcept
+	{
+		using L = Lanes<T>;
+
+		const T two = L::Set(2.0f);
+		const T one = L::Set(1.0f);
+
+		T gradientX, gradientZ;
+		L::UnitHalves(HashBits<T>(cornerX, cornerZ, seed), gradientX, gradientZ);
+
+		gradientX = L::Sub(L::Mul(gradientX, two), one);
+		gradientZ = L::Sub(L::Mul(gradientZ, two), one);
+
+		// (0.5 - d^2)^4 falloff, zero outside of the corner's radius
+		T falloff = L::Sub(L::Sub(L::Set(0.5f), L::Mul(offsetX, offsetX)), L::Mul(offsetZ, offsetZ));
+		falloff = L::Max(falloff, L::Set(0.0f));
+		falloff = L::Mul(falloff, falloff);
+		falloff = L::Mul(falloff, falloff);
+
+		return L::Mul(falloff, L::Add(L::Mul(gradientX, offsetX), L::Mul(gradientZ, offsetZ)));
+	}
+
+	// The origin is in skewed space, skewing is linear so the local position is skewed on its own
+	template <typename T>
+	T SimplexLanes(T x, T z, src::noise::OctaveOrigin const& origin, uint32_t seed) noexcept
+	{
+		using L = Lanes<T>;
+		using Int = typename L::Int;
+
+		const T one = L::Set(1.0f);
+		const T unskew = L::Set(g_simplexUnskew);
+
+		// Cell of the skewed grid, then position relative to its first corner (unskewed)
+		const T skew = L::Mul(L::Add(x, z), L::Set(g_simplexSkewF));
+
+		T skewedX, skewedZ;
+		const Int latticeX = Cell(L::Add(L::Add(x, skew), L::Set(origin.m_offsetX)), origin.m_cellX, skewedX);
+		const Int latticeZ = Cell(L::Add(L::Add(z, skew), L::Set(origin.m_offsetZ)), origin.m_cellZ, skewedZ);
+
+		const T cellUnskew = L::Mul(L::Add(skewedX, skewedZ), unskew);
+		const T offsetX0 = L::Sub(skewedX, cellUnskew);
+		const T offsetZ0 = L::Sub(skewedZ, cellUnskew);
+
+		// Lower or upper triangle of the cell decides the middle corner
+		const T middleX = L::Greater(offsetX0, offsetZ0);
+		const T middleZ = L::Sub(one, middleX);
+
+		const T offsetX1 = L::Add(L::Sub(offsetX0, middleX), unskew);
+		const T offsetZ1 = L::Add(L::Sub(offsetZ0, middleZ), unskew);
+		const T offsetX2 = L::Add(L::Sub(offsetX0, one), L::Set(2.0f * g_simplexUnskew));
+		const T offsetZ2 = L::Add(L::Sub(offsetZ0, one), L::Set(2.0f * g_simplexUnskew));
+
+		const Int latticeX1 = L::AddInt(latticeX, L::SetInt(1));
+		const Int latticeZ1 = L::AddInt(latticeZ, L::SetInt(1));
+
+		T result = SimplexCorner(latticeX, latticeZ, offsetX0, offsetZ0, seed);
+		result = L::Add(result, SimplexCorner(L::AddInt(latticeX, L::ToInt(middleX)), L::AddInt(latticeZ, L::ToInt(middleZ)), offsetX1, offsetZ1, seed));
+		result = L::Add(result, SimplexCorner(latticeX1, latticeZ1, offsetX2, offsetZ2, seed));
+
+		// Same 0 - 1 range as the value noise so every fractal keeps its bounds
+		result = L::Add(L::Mul(result, L::Set(0.5f * g_simplexScale)), L::Set(0.5f));
+
+		return L::Min(L::Max(result, L::Set(0.0f)), one);
+	}
+
+	template <typename T>
+	T BasisLanes(T x, T z, src::noise::OctaveOrigin const& origin, src::noise::NoiseParams const& params) noexcept
+	{
+		if (params.m_basis == src::noise::BASIS_SIMPLEX)
+			return SimplexLanes(x, z, origin, params.m_seed);
+
+		return PerlinLanes(x, z, origin, params.m_seed);
+	}
+
+	template <typename T>
+	T FbmLanes(T x, T z, src::noise::NoiseOrigin const& origin, src::noise::NoiseParams const& params) noexcept
+	{
+		using L = Lanes<T>;
+
+		const int octaveCount = OctaveCount(params);
+		T total = L::Set(0.0f);
+		float frequency = 1.0f;
+		float amplitude = 1.0f;
+
+		for (int i = 0; i < octaveCount; ++i)
+		{
+			const T octave = BasisLanes(L::Mul(x, L::Set(frequency)), L::Mul(z, L::Set(frequency)), origin.m_octaves[i], params);
+
+			total = L::Add(total, L::Mul(octave, L::Set(amplitude)));
+			frequency *= params.m_lacunarity;
+			amplitude *= params.m_persistence;
+		}
+
+		return total;
+	}
+
+	template <typename T>
+	T RidgedLanes(T x, T z, src::noise::NoiseOrigin const& origin, src::noise::NoiseParams const& params) noexcept
+	{
+		using L = Lanes<T>;
+
+		const int octaveCount = OctaveCount(params);
+		const T one = L::Set(1.0f);
+		T total = L::Set(0.0f);
+		T weight = one;
+		float frequency = 1.0f;
+		float amplitude = 1.0f;
+
+		for (int i = 0; i < octaveCount; ++i)
+		{
+			// Crest where the noise crosses its middle, sharpened by squaring
+			T octave = BasisLanes(L::Mul(x, L::Set(frequency)), L::Mul(z, L::Set(frequency)), origin.m_octaves[i], params);
+			octave = L::Sub(one, L::Abs(L::Sub(L::Mul(octave, L::Set(2.0f)), one)));
+			octave = L::Mul(octave, octave);
+
+			// Valleys stay smooth, detail accumulates along crests
+			octave = L::Mul(octave, weight);
+			weight = L::Min(L::Max(L::Mul(octave, L::Set(params.m_ridgeGain)), L::Set(0.0f)), one);
+
+			total = L::Add(total, L::Mul(octave, L::Set(amplitude)));
+			frequency *= params.m_lacunarity;
+			amplitude *= params.m_persistence;
+		}
+
+		return total;
+	}
+
+	template <typename T>
+	T BillowLanes(T x, T z, src::noise::NoiseOrigin const& origin, src::noise::NoiseParams const& params) noexcept
+	{
+		using L = Lanes<T>;
+
+		const int octaveCount = OctaveCount(params);
+		T total = L::Set(0.0f);
+		float frequency = 1.0f;
+		float amplitude = 1.0f;
+
+		for (int i = 0; i < octaveCount; ++i)
+		{
+			T octave = BasisLanes(L::Mul(x, L::Set(frequency)), L::Mul(z, L::Set(frequency)), origin.m_octaves[i], params);
+			octave = L::Abs(L::Sub(L::Mul(octave, L::Set(2.0f)), L::Set(1.0f)));
+
+			total = L::Add(total, L::Mul(octave, L::Set(amplitude)));
+			frequency *= params.m_lacunarity;
+			amplitude *= params.m_persistence;
+		}
+
+		return total;
+	}
+
+	template <typename T>
+	T DomainWarpedLanes(T x, T z, src::noise::NoiseOrigin const& origin, src::noise::NoiseParams const& params) noexcept
+	{
+		using L = Lanes<T>;
+
+		// Two decorrelated fBm centered on 0 offset the sample position
+		const T halfRange = L::Set(MaxAmplitude(params) * 0.5f);
+		const T strength = L::Set(params.m_warpStrength);
+
+		const T warpX = L::Sub(FbmLanes(L::Add(x, L::Set(5.2f)), L::Add(z, L::Set(1.3f)), origin, params), halfRange);
+		const T warpZ = L::Sub(FbmLanes(L::Add(x, L::Set(1.7f)), L::Add(z, L::Set(9.2f)), origin, params), halfRange);
+
+		return FbmLanes(L::Add(x, L::Mul(warpX, strength)), L::Add(z, L::Mul(warpZ, strength)), origin, params);
+	}
+
+	template <typename T>
+	T FractalLanes(T x, T z, src::noise::NoiseOrigin const& origin, src::noise::NoiseParams const& params) noexcept
+	{
+		switch (params.m_type)
+		{
+		case src::noise::NOISE_RIDGED:
+			return RidgedLanes(x, z, origin, params);
+		case src::noise::NOISE_BILLOW:
+			return BillowLanes(x, z, origin, params);
+		case src::noise::NOISE_DOMAIN_WARP:
+			return DomainWarpedLanes(x, z, origin, params);
+		default:
+			return FbmLanes(x, z, origin, params);
+		}
+	}
+}
+
+uint64_t src::noise::NoiseParams::Hash(void) const noexcept
+{
+	// Stored in baked tile archives, the field order must not change
+	StableHash hash;
+
+	hash.Add(m_seed).Add(g_algorithmVersion);
+	hash.Add(m_scale).Add(m_heightScale).Add(m_persistence).Add(m_lacunarity);
+	hash.Add(static_cast<int32_t>(m_octaves)).Add(static_cast<int32_t>(m_type)).Add(static_cast<int32_t>(m_basis));
+	hash.Add(m_ridgeGain).Add(m_warpStrength);
+
+	return hash.Get();
+}
+
+src::noise::NoiseOrigin src::noise::MakeNoiseOrigin(double worldX, double worldZ, NoiseParams const& params) noexcept
+{
+	NoiseOrigin origin;
+	float frequency = 1.0f;
+
+	// Same frequencies as the octave loops, only the origin is evaluated in double precision
+	for (int i = 0; i < s_maxOctaves; ++i)
+	{
+		const double scale = static_cast<double>(params.m_scale) * static_cast<double>(frequency);
+		double x = worldX * scale;
+		double z = worldZ * scale;
+
+		if (params.m_basis == BASIS_SIMPLEX)
+		{
+			const double skew = (x + z) * g_simplexSkew;
+
+			x += skew;
+			z += skew;
+		}
+
+		origin.m_octaves[i] = MakeOctaveOrigin(x, z);
+		frequency *= params.m_lacunarity;
+	}
+
+	return origin;
+}
+
+src::noise::NoiseOrigin src::noise::MakeNoiseOrigin(ChunkCoord const& chunk, double chunkSize, NoiseParams const& params) noexcept
+{
+	return MakeNoiseOrigin(static_cast<double>(chunk.m_x) * chunkSize, static_cast<double>(chunk.m_z) * chunkSize, params);
+}
+
+float src::noise::Hash(uint32_t x, uint32_t z, uint32_t seed) noexcept
+{
+	return Lanes<float>::Unit(HashBits<float>(x, z, seed));
+}
+
+float src::noise::PerlinNoise2D(float x, float z, uint32_t seed) noexcept
+{
+	return PerlinLanes(x, z, OctaveOrigin(), seed);
+}
+
+float src::noise::SimplexNoise2D(float x, float z, uint32_t seed) noexcept
+{
+	return SimplexLanes(x, z, OctaveOrigin(), seed);
+}
+
+float src::noise::FractalPerlinNoise(float x, float z, NoiseParams const& params) noexcept
+{
+	// Loop the perlin noise function multiple times to create layered perlin noise
+	return FbmLanes(x, z, g_worldOrigin, params);
+}
+
+float src::noise::RidgedNoise(float x, float z, NoiseParams const& params) noexcept
+{
+	return RidgedLanes(x, z, g_worldOrigin, params);
+}
+
+float src::noise::BillowNoise(float x, float z, NoiseParams const& params) noexcept
+{
+	return BillowLanes(x, z, g_worldOrigin, params);
+}
+
+float src::noise::DomainWarpedNoise(float x, float z, NoiseParams const& params) noexcept
+{
+	return DomainWarpedLanes(x, z, g_worldOrigin, params);
+}
+
+float src::noise::FractalNoise(float x, float z, NoiseParams const& params) noexcept
+{
+	return FractalLanes(x, z, g_worldOrigin, params);
+}
+
+float src::noise::SampleHeight(float worldX, float worldZ, NoiseParams const& params) noexcept
+{
+	return SampleHeight(g_worldOrigin, worldX, worldZ, params);
+}
+
+float src::noise::SampleHeight(NoiseOrigin const& origin, float localX, float localZ, NoiseParams const& params) noexcept
+{
+	return FractalLanes(localX * params.m_scale, localZ * params.m_scale, origin, params) * params.m_heightScale;
+}
+
+void src::noise::SampleHeights(NoiseOrigin const& origin, float const* localX, float const* localZ, float* heights, size_t count, NoiseParams const& params) noexcept
+{
+	size_t i = 0;
+
+#ifdef SRC_SIMD_SSE2
+	const __m128 scale = _mm_set1_ps(params.m_scale);
+	const __m128 heightScale = _mm_set1_ps(params.m_heightScale);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 x = _mm_mul_ps(_mm_loadu_ps(localX + i), scale);
+		const __m128 z = _mm_mul_ps(_mm_loadu_ps(localZ + i), scale);
+
+		_mm_storeu_ps(heights + i, _mm_mul_ps(FractalLanes(Float4{x}, Float4{z}, origin, params).m_value, heightScale));
+	}
+#endif
+
+	for (; i < count; ++i)
+		heights[i] = SampleHeight(origin, localX[i], localZ[i], params);
+}
+
+float src::noise::MaxHeight(NoiseParams const& params) noexcept
+{
+	return MaxAmplitude(params) * params.m_heightScale;
+}
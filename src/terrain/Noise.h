@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace src::noise
+{
+	// Terrain styles, same values as the 'noiseType' uniform of Terrain.tese
+	enum ENoiseType : int
+	{
+		NOISE_FBM = 0,			// Sum of value noise octaves
+		NOISE_RIDGED = 1,		// Ridged multifractal, sharp crests weighted by the previous octave
+		NOISE_BILLOW = 2,		// Absolute value octaves, rounded hills
+		NOISE_DOMAIN_WARP = 3	// fBm sampled at a position offset by two other fBm
+	};
+
+	// Lattice noise every octave is built from, same values as the 'noiseBasis' uniform of Terrain.tese
+	enum ENoiseBasis : int
+	{
+		BASIS_VALUE = 0,		// Smoothstep between the 4 hashed corners of a square cell, shows axis aligned features
+		BASIS_SIMPLEX = 1		// Gradient noise over the 3 corners of a simplex (triangle) cell, isotropic
+	};
+
+	// CPU mirror of the noise parameters used by Terrain.tese
+	struct NoiseParams
+	{
+		ENoiseType	m_type = NOISE_FBM;
+		ENoiseBasis	m_basis = BASIS_VALUE;
+		uint32_t	m_seed = 0;
+		float		m_scale = 0.05f;		// Controls frequency of terrain features
+		float		m_heightScale = 25.0f;	// Controls vertical exaggeration
+		float		m_persistence = 0.5f;	// Controls amplitude decay
+		float		m_lacunarity = 2.0f;	// Controls frequency growth
+		int			m_octaves = 5;			// At most s_maxOctaves
+		float		m_ridgeGain = 2.0f;		// Ridged, how much a crest sharpens the next octave
+		float		m_warpStrength = 4.0f;	// Domain warp, offset in noise space
+
+		// Same value on every platform, identifies baked tiles
+		uint64_t Hash(void) const noexcept;
+	};
+
+	// Octaves past this count are ignored
+	constexpr int s_maxOctaves = 8;
+
+	// Integer part of a world position, in chunks of a size chosen by the caller
+	struct ChunkCoord
+	{
+		int64_t		m_x = 0;
+		int64_t		m_z = 0;
+	};
+
+	// Lattice position of an origin at one octave's frequency, cells wrap at 2^32 through the hash
+	struct OctaveOrigin
+	{
+		uint32_t	m_cellX = 0;
+		uint32_t	m_cellZ = 0;
+		float		m_offsetX = 0.0f;	// 0 - 1 inside the cell
+		float		m_offsetZ = 0.0f;
+	};
+
+	/*
+	*	Every octave's lattice position of a world origin, same layout as the std140 'noiseOrigin'
+	*	array of Terrain.tese. It is computed once in double precision, samples then only add a
+	*	small float offset relative to it and hash integer cells, so the cost and accuracy of the
+	*	noise do not depend on the distance to the world origin. Simplex origins are skewed.
+	*/
+	struct NoiseOrigin
+	{
+		OctaveOrigin m_octaves[s_maxOctaves];
+	};
+
+	NoiseOrigin MakeNoiseOrigin(double worldX, double worldZ, NoiseParams const& params) noexcept;
+	NoiseOrigin MakeNoiseOrigin(ChunkCoord const& chunk, double chunkSize, NoiseParams const& params) noexcept;
+
+	// Return random number between 0 - 1 for a lattice cell
+	float Hash(uint32_t x, uint32_t z, uint32_t seed) noexcept;
+
+	// Value noise, 0 - 1
+	float PerlinNoise2D(float x, float z, uint32_t seed) noexcept;
+
+	// Simplex gradient noise remapped to 0 - 1, one hash per corner (3 instead of 4)
+	float SimplexNoise2D(float x, float z, uint32_t seed) noexcept;
+
+	// Noise space functions around the world origin (no scaling)
+	float FractalPerlinNoise(float x, float z, NoiseParams const& params) noexcept;
+	float RidgedNoise(float x, float z, NoiseParams const& params) noexcept;
+	float BillowNoise(float x, float z, NoiseParams const& params) noexcept;
+	float DomainWarpedNoise(float x, float z, NoiseParams const& params) noexcept;
+
+	// Variant selected by params.m_type, every variant lies in [0, MaxHeight / heightScale]
+	float FractalNoise(float x, float z, NoiseParams const& params) noexcept;
+
+	// Height of the terrain at a world position, matches the displacement done in Terrain.tese
+	float SampleHeight(float worldX, float worldZ, NoiseParams const& params) noexcept;
+
+	// Height at 'local' world units from the origin, precise at any distance
+	float SampleHeight(NoiseOrigin const& origin, float localX, float localZ, NoiseParams const& params) noexcept;
+
+	/*
+	*	Batched SampleHeight, 4 samples per iteration with SSE2. The scalar functions use the
+	*	same operations in the same order so results are identical.
+	*/
+	void SampleHeights(NoiseOrigin const& origin, float const* localX, float const* localZ, float* heights, size_t count, NoiseParams const& params) noexcept;
+
+	// Upper bound of FractalNoise * heightScale, useful for conservative bounds
+	float MaxHeight(NoiseParams const& params) noexcept;
+}
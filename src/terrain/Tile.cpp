@@ -0,0 +1,81 @@
+#include "terrain/Tile.h"
+#include "terrain/HeightField.h"
+#include "utility/Hash.h"
+
+#include <tuple>
+
+src::TileKey src::TileKey::Make(TileSettings const& settings, uint32_t lod, int32_t x, int32_t z) noexcept
+{
+	return TileKey{settings.m_noise.m_seed, settings.Hash(), lod, x, z};
+}
+
+bool src::TileKey::operator<(TileKey const& key) const noexcept
+{
+	return std::tie(m_seed, m_paramsHash, m_lod, m_z, m_x) <
+		   std::tie(key.m_seed, key.m_paramsHash, key.m_lod, key.m_z, key.m_x);
+}
+
+size_t src::TileKeyHash::operator()(TileKey const& key) const noexcept
+{
+	uint64_t hash = key.m_paramsHash;
+
+	hash ^= (static_cast<uint64_t>(key.m_seed) << 32) | key.m_lod;
+	hash *= 0x9E3779B97F4A7C15ull;
+	hash ^= (static_cast<uint64_t>(static_cast<uint32_t>(key.m_x)) << 32) | static_cast<uint32_t>(key.m_z);
+	hash *= 0xBF58476D1CE4E5B9ull;
+
+	return static_cast<size_t>(hash ^ (hash >> 31));
+}
+
+uint64_t src::TileSettings::Hash(void) const noexcept
+{
+	// Stored in baked tile archives, the field order must not change
+	StableHash hash;
+
+	hash.Add(m_noise.Hash()).Add(m_tileSize).Add(m_resolution);
+	hash.Add(m_hydraulicErosion).Add(m_thermalErosion);
+
+	if (m_hydraulicErosion)
+		hash.Add(m_erosion.Hash());
+
+	if (m_thermalErosion)
+		hash.Add(m_thermal.Hash());
+
+	return hash.Get();
+}
+
+float src::TileWorldSize(TileSettings const& settings, uint32_t lod) noexcept
+{
+	return settings.m_tileSize * static_cast<float>(1u << lod);
+}
+
+std::shared_ptr<src::HeightField> src::GenerateTile(TileKey const& key, TileSettings const& settings)
+{
+	const float worldSize = TileWorldSize(settings, key.m_lod);
+	const math::Vector2<float> origin(static_cast<float>(key.m_x) * worldSize, static_cast<float>(key.m_z) * worldSize);
+
+	// Noise is anchored on the integer tile coordinates, far tiles are as precise as near ones
+	const noise::NoiseOrigin noiseOrigin = noise::MakeNoiseOrigin(noise::ChunkCoord{key.m_x, key.m_z}, static_cast<double>(worldSize), settings.m_noise);
+
+	auto tile = std::make_shared<HeightField>(origin, worldSize / static_cast<float>(settings.m_resolution), settings.m_resolution);
+	tile->Generate(settings.m_noise, noiseOrigin);
+
+	if (settings.m_hydraulicErosion)
+	{
+		erosion::ErosionParams erosion = settings.m_erosion;
+		erosion.m_keepBorders = true;
+		erosion.m_seed = static_cast<uint32_t>(StableHash().Add(erosion.m_seed).Add(key.m_lod).Add(key.m_x).Add(key.m_z).Get());
+
+		erosion::Erode(*tile, erosion, nullptr);
+	}
+
+	if (settings.m_thermalErosion)
+	{
+		erosion::ThermalParams thermal = settings.m_thermal;
+		thermal.m_keepBorders = true;
+
+		erosion::ErodeThermal(*tile, thermal, nullptr);
+	}
+
+	return tile;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "terrain/Erosion.h"
+#include "terrain/Noise.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace src
+{
+	class HeightField;
+	struct TileSettings;
+
+	// Identifies a generated tile, tiles of a given LOD cover (tileSize * 2^lod) world units per side
+	struct TileKey
+	{
+		uint32_t	m_seed = 0;
+		uint64_t	m_paramsHash = 0; // TileSettings::Hash, tiles generated with other settings never match
+		uint32_t	m_lod = 0;
+		int32_t		m_x = 0;
+		int32_t		m_z = 0;
+
+		static TileKey Make(TileSettings const& settings, uint32_t lod, int32_t x, int32_t z) noexcept;
+
+		bool operator==(TileKey const& key) const noexcept = default;
+		bool operator<(TileKey const& key) const noexcept;
+	};
+
+	struct TileKeyHash
+	{
+		size_t operator()(TileKey const& key) const noexcept;
+	};
+
+	struct TileSettings
+	{
+		noise::NoiseParams	m_noise;
+		float				m_tileSize = 64.0f;	// World size of a LOD 0 tile
+		unsigned int		m_resolution = 64;	// Cells per tile side
+
+		// Post-processes of generated tiles (hydraulic then thermal), borders are kept so neighbouring tiles still match
+		bool					m_hydraulicErosion = false;
+		erosion::ErosionParams	m_erosion; // The seed is mixed with the tile key, every tile gets its own droplets
+		bool					m_thermalErosion = false;
+		erosion::ThermalParams	m_thermal;
+
+		// Covers every setting changing the generated heights, parameters of disabled passes are ignored
+		uint64_t Hash(void) const noexcept;
+	};
+
+	float TileWorldSize(TileSettings const& settings, uint32_t lod) noexcept;
+
+	// Sample the noise for the area covered by 'key', then apply the enabled post-processes
+	std::shared_ptr<HeightField> GenerateTile(TileKey const& key, TileSettings const& settings);
+}
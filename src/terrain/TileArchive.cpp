@@ -0,0 +1,356 @@
+#include "terrain/TileArchive.h"
+#include "terrain/HeightField.h"
+#include "terrain/TileCodec.h"
+#include "utility/File.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace
+{
+	constexpr char g_archiveMagic[8] = {'T', 'G', 'T', 'I', 'L', 'E', 'S', '\0'};
+
+	// Each header slot gets half of the first page
+	constexpr uint64_t g_headerSlotSize = src::TileArchive::s_pageSize / 2;
+
+	static_assert(sizeof(src::TileArchive::Header) <= g_headerSlotSize);
+	static_assert(sizeof(src::TileArchive::IndexEntry) == 64);
+
+	inline uint64_t AlignUp(uint64_t value, uint64_t alignment) noexcept
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// Written so corrupted values can't overflow and pass
+	bool IsIndexInBounds(src::TileArchive::Header const& header, uint64_t fileSize) noexcept
+	{
+		return header.m_indexOffset <= fileSize &&
+			   header.m_indexCount <= (fileSize - header.m_indexOffset) / sizeof(src::TileArchive::IndexEntry);
+	}
+
+	bool KeyLess(src::TileArchive::IndexEntry const& entry, src::TileKey const& key) noexcept
+	{
+		return entry.GetKey() < key;
+	}
+}
+
+src::TileKey src::TileArchive::IndexEntry::GetKey(void) const noexcept
+{
+	return TileKey{m_seed, m_paramsHash, m_lod, m_x, m_z};
+}
+
+bool src::TileArchive::Open(const char* filePath)
+{
+	Close();
+
+	if (!m_file.Open(filePath))
+		return false;
+
+	Header header;
+
+	if (m_file.GetSize() < s_pageSize || !ReadHeader(m_file.GetData(), m_file.GetSize(), header))
+	{
+		std::printf("Failed to open tile archive '%s', no valid header.\n", filePath);
+		Close();
+		return false;
+	}
+
+	if (!IsIndexInBounds(header, m_file.GetSize()) ||
+		Checksum(m_file.GetData() + header.m_indexOffset, static_cast<size_t>(header.m_indexCount * sizeof(IndexEntry))) != header.m_indexChecksum)
+	{
+		std::printf("Failed to open tile archive '%s', tile index is corrupted.\n", filePath);
+		Close();
+		return false;
+	}
+
+	m_index = reinterpret_cast<IndexEntry const*>(m_file.GetData() + header.m_indexOffset);
+	m_indexCount = header.m_indexCount;
+
+	return true;
+}
+
+void src::TileArchive::Close(void) noexcept
+{
+	m_file.Close();
+	m_index = nullptr;
+	m_indexCount = 0;
+}
+
+bool src::TileArchive::IsOpen(void) const noexcept
+{
+	return m_index != nullptr;
+}
+
+bool src::TileArchive::Contains(TileKey const& key) const
+{
+	TileView view;
+	return Find(key, view);
+}
+
+bool src::TileArchive::Find(TileKey const& key, TileView& view) const
+{
+	if (!m_index)
+		return false;
+
+	IndexEntry const* end = m_index + m_indexCount;
+	IndexEntry const* entry = std::lower_bound(m_index, end, key, KeyLess);
+
+	if (entry == end || !(entry->GetKey() == key))
+		return false;
+
+	view.m_entry = entry;
+	view.m_payload = m_file.GetData() + entry->m_offset;
+
+	return true;
+}
+
+std::shared_ptr<src::HeightField> src::TileArchive::LoadTile(TileKey const& key) const
+{
+	TileView view;
+
+	if (!Find(key, view))
+		return nullptr;
+
+	IndexEntry const& entry = *view.m_entry;
+
+	if (entry.m_offset > m_file.GetSize() || entry.m_size > m_file.GetSize() - entry.m_offset || Checksum(view.m_payload, entry.m_size) != entry.m_checksum)
+	{
+		std::printf("Failed to load tile (%d, %d) LOD %u from archive, payload is corrupted.\n", key.m_x, key.m_z, key.m_lod);
+		return nullptr;
+	}
+
+	auto tile = std::make_shared<HeightField>(math::Vector2<float>(entry.m_originX, entry.m_originZ), entry.m_cellSize, entry.m_resolution);
+	std::vector<float>& heights = tile->GetHeights();
+
+	switch (entry.m_encoding)
+	{
+	case ENCODING_RAW_FLOAT:
+		if (entry.m_size != heights.size() * sizeof(float))
+			return nullptr;
+
+		std::memcpy(heights.data(), view.m_payload, entry.m_size);
+		break;
+	case ENCODING_QUANTIZED:
+		if (!codec::DecodeHeights(view.m_payload, entry.m_size, heights.data(), tile->GetSamplesPerSide()))
+		{
+			std::printf("Failed to decode tile (%d, %d) LOD %u from archive.\n", key.m_x, key.m_z, key.m_lod);
+			return nullptr;
+		}
+		break;
+	default:
+		std::printf("Failed to load tile (%d, %d) LOD %u from archive, unknown encoding %u.\n", key.m_x, key.m_z, key.m_lod, entry.m_encoding);
+		return nullptr;
+	}
+
+	tile->BuildPyramid();
+	tile->ComputeNormals();
+
+	return tile;
+}
+
+uint64_t src::TileArchive::GetTileCount(void) const noexcept
+{
+	return m_indexCount;
+}
+
+bool src::TileArchive::ReadHeader(const std::byte* headerPage, uint64_t pageSize, Header& header)
+{
+	if (pageSize < s_pageSize)
+		return false;
+
+	bool found = false;
+
+	for (uint64_t slot = 0; slot < 2; ++slot)
+	{
+		Header candidate;
+		std::memcpy(&candidate, headerPage + slot * g_headerSlotSize, sizeof(Header));
+
+		// A torn write leaves a slot with a bad checksum, the other slot is still valid
+		const bool valid = std::memcmp(candidate.m_magic, g_archiveMagic, sizeof(g_archiveMagic)) == 0 &&
+						   candidate.m_version == s_version &&
+						   candidate.m_pageSize == s_pageSize &&
+						   candidate.m_headerChecksum == Checksum(&candidate, offsetof(Header, m_headerChecksum));
+
+		if (valid && (!found || candidate.m_generation > header.m_generation))
+		{
+			header = candidate;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+uint32_t src::TileArchive::Checksum(const void* data, size_t size) noexcept
+{
+	// FNV-1a
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint32_t hash = 2166136261u;
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+src::TileArchiveWriter::TileArchiveWriter(const char* filePath, unsigned int precisionBits)
+	: m_filePath(filePath), m_precisionBits(precisionBits)
+{
+}
+
+void src::TileArchiveWriter::Add(TileKey const& key, HeightField const& tile)
+{
+	std::vector<float> const& heights = tile.GetHeights();
+
+	PendingTile pending;
+
+	if (m_precisionBits > 0)
+		codec::EncodeHeights(heights.data(), tile.GetSamplesPerSide(), pending.m_payload, m_precisionBits);
+	else
+	{
+		pending.m_payload.resize(heights.size() * sizeof(float));
+		std::memcpy(pending.m_payload.data(), heights.data(), pending.m_payload.size());
+	}
+
+	TileArchive::IndexEntry& entry = pending.m_entry;
+	entry = {};
+	entry.m_seed = key.m_seed;
+	entry.m_lod = key.m_lod;
+	entry.m_paramsHash = key.m_paramsHash;
+	entry.m_x = key.m_x;
+	entry.m_z = key.m_z;
+	entry.m_size = static_cast<uint32_t>(pending.m_payload.size());
+	entry.m_encoding = (m_precisionBits > 0) ? TileArchive::ENCODING_QUANTIZED : TileArchive::ENCODING_RAW_FLOAT;
+	entry.m_resolution = tile.GetResolution();
+	entry.m_cellSize = tile.GetCellSize();
+	entry.m_originX = tile.GetOrigin()[0];
+	entry.m_originZ = tile.GetOrigin()[1];
+	entry.m_checksum = TileArchive::Checksum(pending.m_payload.data(), pending.m_payload.size());
+
+	m_pendingTiles.push_back(std::move(pending));
+}
+
+bool src::TileArchiveWriter::Commit(void)
+{
+	if (m_pendingTiles.empty())
+		return true;
+
+	// Read the current generation, its index is merged with the new tiles
+	TileArchive::Header header = {};
+	std::vector<TileArchive::IndexEntry> entries;
+	bool hasHeader = false;
+
+	if (std::filesystem::exists(m_filePath))
+	{
+		MappedFile currentFile;
+
+		if (currentFile.Open(m_filePath.c_str()) && currentFile.GetSize() >= TileArchive::s_pageSize)
+			hasHeader = TileArchive::ReadHeader(currentFile.GetData(), currentFile.GetSize(), header);
+
+		// Not an archive or both slots are damaged, rewriting it would destroy the file
+		if (!hasHeader)
+		{
+			std::printf("Failed to append to tile archive '%s', the file exists but has no valid header.\n", m_filePath.c_str());
+			return false;
+		}
+
+		if (!IsIndexInBounds(header, currentFile.GetSize()))
+		{
+			std::printf("Failed to append to tile archive '%s', tile index is out of bounds.\n", m_filePath.c_str());
+			return false;
+		}
+
+		auto const* index = reinterpret_cast<TileArchive::IndexEntry const*>(currentFile.GetData() + header.m_indexOffset);
+		entries.assign(index, index + header.m_indexCount);
+	}
+
+	File file;
+
+	if (!file.Open(m_filePath.c_str(), hasHeader ? FILE_READ_WRITE : FILE_WRITE))
+		return false;
+
+	if (!hasHeader)
+	{
+		// Fresh archive, reserve the header page
+		std::vector<std::byte> headerPage(TileArchive::s_pageSize);
+
+		if (!file.WriteAt(0, headerPage.data(), headerPage.size()))
+			return false;
+
+		header.m_fileEnd = TileArchive::s_pageSize;
+	}
+
+	uint64_t writeOffset = AlignUp(header.m_fileEnd, TileArchive::s_pageSize);
+
+	// Payloads, appended after the current entries so they win over older tiles with the same key
+	for (PendingTile& pending : m_pendingTiles)
+	{
+		if (!file.WriteAt(writeOffset, pending.m_payload.data(), pending.m_payload.size()))
+		{
+			std::printf("Failed to write tile payload to archive '%s'.\n", m_filePath.c_str());
+			return false;
+		}
+
+		pending.m_entry.m_offset = writeOffset;
+		writeOffset = AlignUp(writeOffset + pending.m_payload.size(), TileArchive::s_pageSize);
+
+		entries.push_back(pending.m_entry);
+	}
+
+	auto keyLess = [](TileArchive::IndexEntry const& lhs, TileArchive::IndexEntry const& rhs)
+	{
+		return lhs.GetKey() < rhs.GetKey();
+	};
+
+	// Stable sort keeps duplicates in insertion order, only the last one of each key is kept
+	std::stable_sort(entries.begin(), entries.end(), keyLess);
+
+	size_t entryCount = 0;
+
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		if (i + 1 < entries.size() && !keyLess(entries[i], entries[i + 1]))
+			continue;
+
+		entries[entryCount++] = entries[i];
+	}
+
+	entries.resize(entryCount);
+
+	const size_t indexSize = entries.size() * sizeof(TileArchive::IndexEntry);
+
+	if (!file.WriteAt(writeOffset, entries.data(), indexSize) || !file.Sync())
+	{
+		std::printf("Failed to write tile index to archive '%s'.\n", m_filePath.c_str());
+		return false;
+	}
+
+	// Publish the new generation through the inactive header slot
+	TileArchive::Header newHeader = {};
+	std::memcpy(newHeader.m_magic, g_archiveMagic, sizeof(g_archiveMagic));
+	newHeader.m_version = TileArchive::s_version;
+	newHeader.m_pageSize = TileArchive::s_pageSize;
+	newHeader.m_generation = header.m_generation + 1;
+	newHeader.m_indexOffset = writeOffset;
+	newHeader.m_indexCount = entries.size();
+	newHeader.m_fileEnd = writeOffset + indexSize;
+	newHeader.m_indexChecksum = TileArchive::Checksum(entries.data(), indexSize);
+	newHeader.m_headerChecksum = TileArchive::Checksum(&newHeader, offsetof(TileArchive::Header, m_headerChecksum));
+
+	const uint64_t slotOffset = (newHeader.m_generation % 2) * g_headerSlotSize;
+
+	if (!file.WriteAt(slotOffset, &newHeader, sizeof(newHeader)) || !file.Sync())
+	{
+		std::printf("Failed to write header to tile archive '%s'.\n", m_filePath.c_str());
+		return false;
+	}
+
+	m_pendingTiles.clear();
+
+	return true;
+}
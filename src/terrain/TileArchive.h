@@ -0,0 +1,133 @@
+#pragma once
+
+#include "terrain/Tile.h"
+#include "terrain/TileCodec.h"
+#include "utility/MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace src
+{
+	class HeightField;
+
+	/*
+	*	Single file store for baked tiles, opened through a memory mapping so lookups are
+	*	zero copy and the OS page cache does the caching.
+	*
+	*	Layout:
+	*	- Page 0:			two header slots, the valid slot with the highest generation is current
+	*	- Payload pages:	tile data, each payload starts on a page boundary
+	*	- Index pages:		IndexEntry array sorted by tile key
+	*
+	*	Appends write new payloads and a new index past the end of the file and only then
+	*	publish them by writing the inactive header slot, a crash at any point leaves the
+	*	previous generation intact.
+	*/
+	class TileArchive
+	{
+	public:
+		static constexpr uint32_t s_version = 2; // 2: rANS coded tile payloads
+		static constexpr uint32_t s_pageSize = 4096;
+
+		enum ETileEncoding : uint32_t
+		{
+			ENCODING_RAW_FLOAT = 0,
+			ENCODING_QUANTIZED = 1	// See TileCodec.h
+		};
+
+		struct Header
+		{
+			char		m_magic[8];
+			uint32_t	m_version;
+			uint32_t	m_pageSize;
+			uint64_t	m_generation;
+			uint64_t	m_indexOffset;
+			uint64_t	m_indexCount;
+			uint64_t	m_fileEnd;
+			uint32_t	m_indexChecksum;
+			uint32_t	m_headerChecksum; // Covers every preceding byte of the header
+		};
+
+		struct IndexEntry
+		{
+			uint32_t	m_seed;
+			uint32_t	m_lod;
+			uint64_t	m_paramsHash;
+			int32_t		m_x;
+			int32_t		m_z;
+			uint64_t	m_offset;
+			uint32_t	m_size;
+			uint32_t	m_encoding;
+			uint32_t	m_resolution;
+			float		m_cellSize;
+			float		m_originX;
+			float		m_originZ;
+			uint32_t	m_checksum;
+			uint32_t	m_reserved;
+
+			TileKey GetKey(void) const noexcept;
+		};
+
+		// Points straight into the mapped file
+		struct TileView
+		{
+			IndexEntry const*	m_entry = nullptr;
+			const std::byte*	m_payload = nullptr;
+		};
+
+		TileArchive(void) = default;
+		TileArchive(TileArchive const&) = delete;
+		TileArchive& operator=(TileArchive const&) = delete;
+		~TileArchive(void) = default;
+
+		bool Open(const char* filePath);
+		void Close(void) noexcept;
+		bool IsOpen(void) const noexcept;
+
+		bool Contains(TileKey const& key) const;
+		bool Find(TileKey const& key, TileView& view) const;
+
+		// Decode the tile into a new height field, null if missing or corrupted
+		std::shared_ptr<HeightField> LoadTile(TileKey const& key) const;
+
+		uint64_t GetTileCount(void) const noexcept;
+
+		// Current header of a raw archive page, false when neither slot is valid
+		static bool ReadHeader(const std::byte* headerPage, uint64_t pageSize, Header& header);
+		static uint32_t Checksum(const void* data, size_t size) noexcept;
+
+	private:
+		MappedFile			m_file;
+		IndexEntry const*	m_index = nullptr;
+		uint64_t			m_indexCount = 0;
+	};
+
+	// Accumulates tiles and appends them to an archive (created if missing) on Commit.
+	// An existing file without a valid header is never overwritten, Commit fails instead
+	class TileArchiveWriter
+	{
+	public:
+		TileArchiveWriter(void) = delete;
+		// precisionBits of 0 stores raw floats, otherwise heights are quantized to that many bits (see TileCodec.h)
+		TileArchiveWriter(const char* filePath, unsigned int precisionBits = codec::s_defaultPrecisionBits);
+		~TileArchiveWriter(void) = default;
+
+		void Add(TileKey const& key, HeightField const& tile);
+		bool Commit(void);
+
+	private:
+		struct PendingTile
+		{
+			TileArchive::IndexEntry	m_entry;
+			std::vector<std::byte>	m_payload;
+		};
+
+		std::string					m_filePath;
+		std::vector<PendingTile>	m_pendingTiles;
+		unsigned int				m_precisionBits;
+	};
+}
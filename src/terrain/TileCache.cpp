@@ -0,0 +1,209 @@
+#include "terrain/TileCache.h"
+#include "terrain/HeightField.h"
+
+#include <cstdio>
+
+src::TileCache::TileCache(size_t byteBudget)
+	: m_byteBudget(byteBudget), m_byteSize(0)
+{
+}
+
+std::shared_ptr<src::HeightField> src::TileCache::Acquire(TileKey const& key, Generator const& generator)
+{
+	{
+		std::lock_guard lock(m_mutex);
+
+		if (auto it = m_entries.find(key); it != m_entries.end())
+		{
+			++m_stats.m_hits;
+			++it->second.m_pinCount;
+			Touch(it->second);
+
+			return it->second.m_tile;
+		}
+
+		++m_stats.m_misses;
+	}
+
+	// Generate outside of the lock so other threads can keep hitting the cache
+	std::shared_ptr<HeightField> tile = generator(key);
+
+	if (!tile)
+		return nullptr;
+
+	std::lock_guard lock(m_mutex);
+
+	// Another thread generated the same tile in the meantime, keep theirs
+	if (auto it = m_entries.find(key); it != m_entries.end())
+	{
+		++it->second.m_pinCount;
+		Touch(it->second);
+
+		return it->second.m_tile;
+	}
+
+	InsertLocked(key, tile, 1);
+	EvictLocked();
+
+	return tile;
+}
+
+std::shared_ptr<src::HeightField> src::TileCache::Find(TileKey const& key)
+{
+	std::lock_guard lock(m_mutex);
+
+	auto it = m_entries.find(key);
+
+	if (it == m_entries.end())
+	{
+		++m_stats.m_misses;
+		return nullptr;
+	}
+
+	++m_stats.m_hits;
+	Touch(it->second);
+
+	return it->second.m_tile;
+}
+
+bool src::TileCache::Contains(TileKey const& key)
+{
+	std::lock_guard lock(m_mutex);
+
+	return m_entries.contains(key);
+}
+
+void src::TileCache::Insert(TileKey const& key, std::shared_ptr<HeightField> tile)
+{
+	if (!tile)
+		return;
+
+	std::lock_guard lock(m_mutex);
+
+	if (auto it = m_entries.find(key); it != m_entries.end())
+	{
+		m_byteSize -= it->second.m_byteSize;
+		it->second.m_tile = std::move(tile);
+		it->second.m_byteSize = it->second.m_tile->GetByteSize();
+		m_byteSize += it->second.m_byteSize;
+
+		Touch(it->second);
+	}
+	else
+		InsertLocked(key, std::move(tile), 0);
+
+	EvictLocked();
+}
+
+void src::TileCache::Release(TileKey const& key)
+{
+	std::lock_guard lock(m_mutex);
+
+	auto it = m_entries.find(key);
+
+	if (it == m_entries.end() || it->second.m_pinCount == 0)
+	{
+		std::printf("Failed to release tile (%d, %d) LOD %u, tile is not pinned.\n", key.m_x, key.m_z, key.m_lod);
+		return;
+	}
+
+	--it->second.m_pinCount;
+
+	// Tiles may have been kept over budget while pinned
+	EvictLocked();
+}
+
+void src::TileCache::Clear(void)
+{
+	std::lock_guard lock(m_mutex);
+
+	// Pinned tiles are still referenced by their users so they stay
+	for (auto it = m_entries.begin(); it != m_entries.end();)
+	{
+		if (it->second.m_pinCount == 0)
+		{
+			m_byteSize -= it->second.m_byteSize;
+			m_lru.erase(it->second.m_lruPosition);
+			it = m_entries.erase(it);
+		}
+		else
+			++it;
+	}
+}
+
+void src::TileCache::SetByteBudget(size_t byteBudget)
+{
+	std::lock_guard lock(m_mutex);
+
+	m_byteBudget = byteBudget;
+	EvictLocked();
+}
+
+size_t src::TileCache::GetByteBudget(void) const noexcept
+{
+	return m_byteBudget;
+}
+
+src::TileCache::Stats src::TileCache::GetStats(void)
+{
+	std::lock_guard lock(m_mutex);
+
+	Stats stats = m_stats;
+	stats.m_byteSize = m_byteSize;
+	stats.m_tileCount = m_entries.size();
+	stats.m_pinnedCount = 0;
+
+	for (auto const& entry : m_entries)
+		stats.m_pinnedCount += (entry.second.m_pinCount > 0) ? 1 : 0;
+
+	return stats;
+}
+
+void src::TileCache::ResetCounters(void)
+{
+	std::lock_guard lock(m_mutex);
+
+	m_stats = Stats();
+}
+
+void src::TileCache::Touch(Entry& entry)
+{
+	// Move to the front without reallocating the node
+	m_lru.splice(m_lru.begin(), m_lru, entry.m_lruPosition);
+}
+
+void src::TileCache::InsertLocked(TileKey const& key, std::shared_ptr<HeightField> tile, unsigned int pinCount)
+{
+	m_lru.push_front(key);
+
+	Entry entry;
+	entry.m_byteSize = tile->GetByteSize();
+	entry.m_tile = std::move(tile);
+	entry.m_lruPosition = m_lru.begin();
+	entry.m_pinCount = pinCount;
+
+	m_byteSize += entry.m_byteSize;
+	m_entries.emplace(key, std::move(entry));
+}
+
+void src::TileCache::EvictLocked(void)
+{
+	// Walk from the least recently used end, skipping pinned tiles
+	auto it = m_lru.end();
+
+	while (m_byteSize > m_byteBudget && it != m_lru.begin())
+	{
+		--it;
+
+		auto entryIt = m_entries.find(*it);
+
+		if (entryIt->second.m_pinCount > 0)
+			continue;
+
+		m_byteSize -= entryIt->second.m_byteSize;
+		++m_stats.m_evictions;
+
+		m_entries.erase(entryIt);
+		it = m_lru.erase(it);
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "terrain/Tile.h"
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace src
+{
+	class HeightField;
+
+	/*
+	*	Holds generated tiles up to a byte budget. Least recently used tiles are evicted
+	*	first, pinned tiles (currently in use) are never evicted. Safe to use from several threads.
+	*/
+	class TileCache
+	{
+	public:
+		using Generator = std::function<std::shared_ptr<HeightField>(TileKey const& key)>;
+
+		struct Stats
+		{
+			uint64_t	m_hits = 0;
+			uint64_t	m_misses = 0;
+			uint64_t	m_evictions = 0;
+			size_t		m_byteSize = 0;
+			size_t		m_tileCount = 0;
+			size_t		m_pinnedCount = 0;
+		};
+
+		TileCache(void) = delete;
+		TileCache(size_t byteBudget);
+		TileCache(TileCache const&) = delete;
+		TileCache& operator=(TileCache const&) = delete;
+		~TileCache(void) = default;
+
+		// Return the cached tile or generate it on a miss, the returned tile is pinned until Release
+		std::shared_ptr<HeightField> Acquire(TileKey const& key, Generator const& generator);
+
+		// Return the cached tile without generating it, null on a miss. Does not pin
+		std::shared_ptr<HeightField> Find(TileKey const& key);
+
+		// Check residency without touching the LRU order or the counters
+		bool Contains(TileKey const& key);
+
+		void Insert(TileKey const& key, std::shared_ptr<HeightField> tile);
+		void Release(TileKey const& key);
+		void Clear(void);
+
+		void	SetByteBudget(size_t byteBudget);
+		size_t	GetByteBudget(void) const noexcept;
+		Stats	GetStats(void);
+		void	ResetCounters(void);
+
+	private:
+		struct Entry
+		{
+			std::shared_ptr<HeightField>	m_tile;
+			std::list<TileKey>::iterator	m_lruPosition;
+			size_t							m_byteSize;
+			unsigned int					m_pinCount;
+		};
+
+		void Touch(Entry& entry);
+		void InsertLocked(TileKey const& key, std::shared_ptr<HeightField> tile, unsigned int pinCount);
+		void EvictLocked(void);
+
+		std::unordered_map<TileKey, Entry, TileKeyHash>	m_entries;
+		std::list<TileKey>								m_lru; // Front = most recently used
+		std::mutex										m_mutex;
+		size_t											m_byteBudget;
+		size_t											m_byteSize;
+		Stats											m_stats;
+	};
+}
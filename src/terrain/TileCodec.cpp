@@ -0,0 +1,543 @@
+#include "terrain/TileCodec.h"
+#include "utility/Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	// Residuals share their low bit width in blocks of 128, 32 per lane of a 4 x 32 bit vector
+	constexpr unsigned int g_blockSize = 128;
+	constexpr unsigned int g_laneCount = 4;
+	constexpr unsigned int g_valuesPerLane = g_blockSize / g_laneCount;
+
+	// High bits of every residual are entropy coded, at most this many per residual
+	constexpr unsigned int g_highBits = 4;
+	constexpr unsigned int g_symbolCount = 1u << g_highBits;
+
+	// rANS (Duda) renormalizing 16 bits at a time, probabilities are out of 2^g_probabilityBits.
+	// A state never drops below 2^16 / 2^11 * 1, so it takes at most one 16 bit word to refill
+	constexpr unsigned int g_probabilityBits = 11;
+	constexpr uint32_t g_probabilityTotal = 1u << g_probabilityBits;
+	constexpr uint32_t g_ransLow = 1u << 16;
+
+	// Interleaved states, the decoder cycles through them so their dependency chains overlap
+	constexpr unsigned int g_ransStateCount = 4;
+
+	// Everything the decoder needs from a slot of the probability range in a single load
+	struct SlotEntry
+	{
+		uint16_t	m_frequency;
+		uint16_t	m_bias; // Slot minus the symbol's first slot
+		uint8_t		m_symbol;
+	};
+
+	// Frequencies, then the low bit width of every block, then the low bits, then the rANS bytes
+	struct StreamLayout
+	{
+		size_t	m_frequencies;
+		size_t	m_widths;
+		size_t	m_lowBits;
+		size_t	m_rans;
+		size_t	m_end;
+	};
+
+	inline uint16_t ZigZagEncode(uint16_t value) noexcept
+	{
+		const int16_t signedValue = static_cast<int16_t>(value);
+
+		return static_cast<uint16_t>((static_cast<uint16_t>(signedValue) << 1) ^ static_cast<uint16_t>(signedValue >> 15));
+	}
+
+	inline uint16_t ZigZagDecode(uint16_t value) noexcept
+	{
+		return static_cast<uint16_t>((value >> 1) ^ static_cast<uint16_t>(0u - (value & 1u)));
+	}
+
+	inline unsigned int BitWidth(uint32_t value) noexcept
+	{
+		unsigned int width = 0;
+
+		while (value)
+		{
+			++width;
+			value >>= 1;
+		}
+
+		return width;
+	}
+
+	inline uint32_t Load32(const std::byte* data) noexcept
+	{
+		uint32_t value;
+		std::memcpy(&value, data, sizeof(value));
+
+		return value;
+	}
+
+	inline void Store32(std::byte* data, uint32_t value) noexcept
+	{
+		std::memcpy(data, &value, sizeof(value));
+	}
+
+	inline uint32_t Load16(const std::byte* data) noexcept
+	{
+		uint16_t value;
+		std::memcpy(&value, data, sizeof(value));
+
+		return value;
+	}
+
+	inline void Store16(std::byte* data, uint16_t value) noexcept
+	{
+		std::memcpy(data, &value, sizeof(value));
+	}
+
+	// Low bits of a block take 'width' 16 byte vectors
+	inline size_t LowBitBytes(unsigned int width) noexcept
+	{
+		return static_cast<size_t>(width) * g_laneCount * sizeof(uint32_t);
+	}
+
+	StreamLayout MakeLayout(src::codec::EncodedTileHeader const& header, size_t lowBitBytes) noexcept
+	{
+		StreamLayout layout;
+		layout.m_frequencies = sizeof(src::codec::EncodedTileHeader);
+		layout.m_widths = layout.m_frequencies + g_symbolCount * sizeof(uint16_t);
+		layout.m_lowBits = layout.m_widths + header.m_blockCount;
+		layout.m_rans = layout.m_lowBits + lowBitBytes;
+		layout.m_end = layout.m_rans + header.m_ransBytes;
+
+		return layout;
+	}
+
+	// Scales symbol counts to frequencies summing to g_probabilityTotal, every used symbol keeps at least 1
+	void NormalizeFrequencies(uint32_t const* counts, size_t symbolTotal, uint16_t* frequencies) noexcept
+	{
+		if (symbolTotal == 0)
+		{
+			std::fill(frequencies, frequencies + g_symbolCount, uint16_t(0));
+			frequencies[0] = static_cast<uint16_t>(g_probabilityTotal);
+			return;
+		}
+
+		uint32_t sum = 0;
+		unsigned int largest = 0;
+
+		for (unsigned int symbol = 0; symbol < g_symbolCount; ++symbol)
+		{
+			uint32_t frequency = static_cast<uint32_t>(static_cast<uint64_t>(counts[symbol]) * g_probabilityTotal / symbolTotal);
+
+			if (counts[symbol] > 0 && frequency == 0)
+				frequency = 1;
+
+			frequencies[symbol] = static_cast<uint16_t>(frequency);
+			sum += frequency;
+
+			if (frequency > frequencies[largest])
+				largest = symbol;
+		}
+
+		// Rounding error goes to the most likely symbol, which is at least g_probabilityTotal / g_symbolCount
+		frequencies[largest] = static_cast<uint16_t>(frequencies[largest] + g_probabilityTotal - sum);
+	}
+
+	// Lane l holds values l, l + 4, l + 8... each one 'width' bits after the previous one
+	void PackLowBits(uint16_t const* values, unsigned int width, std::byte* output)
+	{
+		uint32_t words[16 - g_highBits][g_laneCount] = {};
+
+		for (unsigned int lane = 0; lane < g_laneCount; ++lane)
+		{
+			for (unsigned int i = 0; i < g_valuesPerLane; ++i)
+			{
+				const uint32_t value = values[i * g_laneCount + lane] & ((1u << width) - 1);
+				const unsigned int bit = i * width;
+				const unsigned int word = bit / 32;
+				const unsigned int shift = bit % 32;
+
+				words[word][lane] |= value << shift;
+
+				if (shift + width > 32)
+					words[word + 1][lane] |= value >> (32 - shift);
+			}
+		}
+
+		std::memcpy(output, words, LowBitBytes(width));
+	}
+
+	// Every lane is unpacked with the same shifts, 4 values per step
+	void UnpackLowBits(const std::byte* input, unsigned int width, uint16_t* values)
+	{
+		if (width == 0)
+		{
+			std::memset(values, 0, g_blockSize * sizeof(uint16_t));
+			return;
+		}
+
+#ifdef SRC_SIMD_SSE2
+		const __m128i mask = _mm_set1_epi32(static_cast<int>((1u << width) - 1));
+
+		// Two steps per iteration, packed together into 8 residuals
+		auto unpackStep = [input, width, &mask](unsigned int i)
+		{
+			const unsigned int bit = i * width;
+			const unsigned int word = bit / 32;
+			const unsigned int shift = bit % 32;
+
+			__m128i value = _mm_srl_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input) + word), _mm_cvtsi32_si128(static_cast<int>(shift)));
+
+			if (shift + width > 32)
+			{
+				const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input) + word + 1);
+				value = _mm_or_si128(value, _mm_sll_epi32(next, _mm_cvtsi32_si128(static_cast<int>(32 - shift))));
+			}
+
+			// Sign extend the low 16 bits so the saturating pack keeps them as they are
+			value = _mm_and_si128(value, mask);
+			return _mm_srai_epi32(_mm_slli_epi32(value, 16), 16);
+		};
+
+		for (unsigned int i = 0; i < g_valuesPerLane; i += 2)
+		{
+			const __m128i packed = _mm_packs_epi32(unpackStep(i), unpackStep(i + 1));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(values + i * g_laneCount), packed);
+		}
+#else
+		const uint32_t mask = (1u << width) - 1;
+
+		for (unsigned int lane = 0; lane < g_laneCount; ++lane)
+		{
+			for (unsigned int i = 0; i < g_valuesPerLane; ++i)
+			{
+				const unsigned int bit = i * width;
+				const unsigned int word = bit / 32;
+				const unsigned int shift = bit % 32;
+
+				uint32_t value = Load32(input + (word * g_laneCount + lane) * sizeof(uint32_t)) >> shift;
+
+				if (shift + width > 32)
+					value |= Load32(input + ((word + 1) * g_laneCount + lane) * sizeof(uint32_t)) << (32 - shift);
+
+				values[i * g_laneCount + lane] = static_cast<uint16_t>(value & mask);
+			}
+		}
+#endif
+	}
+
+	// Residual rows hold zigzagged gradient predictor residuals, turn one back into quantized heights
+	void DecodeRow(uint16_t const* residuals, uint16_t* previousRow, float* heights, unsigned int width, float min, float step)
+	{
+		uint16_t carry = 0;
+		unsigned int x = 0;
+
+#ifdef SRC_SIMD_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one = _mm_set1_epi16(1);
+		const __m128 minVec = _mm_set1_ps(min);
+		const __m128 stepVec = _mm_set1_ps(step);
+
+		for (; x + 8 <= width; x += 8)
+		{
+			__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(residuals + x));
+
+			// Zigzag decode
+			value = _mm_xor_si128(_mm_srli_epi16(value, 1), _mm_sub_epi16(zero, _mm_and_si128(value, one)));
+
+			// Inclusive prefix sum across the 8 lanes then add the running sum of the previous lanes
+			value = _mm_add_epi16(value, _mm_slli_si128(value, 2));
+			value = _mm_add_epi16(value, _mm_slli_si128(value, 4));
+			value = _mm_add_epi16(value, _mm_slli_si128(value, 8));
+			value = _mm_add_epi16(value, _mm_set1_epi16(static_cast<short>(carry)));
+			carry = static_cast<uint16_t>(_mm_extract_epi16(value, 7));
+
+			// Vertical delta
+			__m128i quantized = _mm_add_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(previousRow + x)), value);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(previousRow + x), quantized);
+
+			// Dequantize
+			const __m128 low = _mm_cvtepi32_ps(_mm_unpacklo_epi16(quantized, zero));
+			const __m128 high = _mm_cvtepi32_ps(_mm_unpackhi_epi16(quantized, zero));
+
+			_mm_storeu_ps(heights + x, _mm_add_ps(minVec, _mm_mul_ps(low, stepVec)));
+			_mm_storeu_ps(heights + x + 4, _mm_add_ps(minVec, _mm_mul_ps(high, stepVec)));
+		}
+#endif
+
+		for (; x < width; ++x)
+		{
+			carry = static_cast<uint16_t>(carry + ZigZagDecode(residuals[x]));
+			previousRow[x] = static_cast<uint16_t>(previousRow[x] + carry);
+			heights[x] = min + static_cast<float>(previousRow[x]) * step;
+		}
+	}
+}
+
+float src::codec::MaxQuantizationError(float min, float max, unsigned int precisionBits) noexcept
+{
+	return (max - min) / static_cast<float>((1u << std::clamp(precisionBits, 1u, 16u)) - 1) * 0.5f;
+}
+
+void src::codec::EncodeHeights(float const* heights, unsigned int samplesPerSide, std::vector<std::byte>& output, unsigned int precisionBits)
+{
+	const size_t sampleCount = static_cast<size_t>(samplesPerSide) * samplesPerSide;
+
+	EncodedTileHeader header;
+	header.m_samplesPerSide = samplesPerSide;
+	header.m_min = (sampleCount > 0) ? *std::min_element(heights, heights + sampleCount) : 0.0f;
+	header.m_max = (sampleCount > 0) ? *std::max_element(heights, heights + sampleCount) : 0.0f;
+	header.m_blockCount = static_cast<uint32_t>((sampleCount + g_blockSize - 1) / g_blockSize);
+	header.m_quantizationSteps = (1u << std::clamp(precisionBits, 1u, 16u)) - 1;
+	header.m_ransBytes = 0;
+
+	// Quantize relative to the tile's range
+	const float steps = static_cast<float>(header.m_quantizationSteps);
+	const float range = header.m_max - header.m_min;
+	const float scale = (range > 0.0f) ? steps / range : 0.0f;
+
+	std::vector<uint16_t> quantized(sampleCount);
+
+	for (size_t i = 0; i < sampleCount; ++i)
+	{
+		const float value = std::round((heights[i] - header.m_min) * scale);
+		quantized[i] = static_cast<uint16_t>(std::clamp(value, 0.0f, steps));
+	}
+
+	// Gradient predictor (left + up - upper left), samples outside the tile count as 0
+	std::vector<uint16_t> residuals(static_cast<size_t>(header.m_blockCount) * g_blockSize, 0);
+
+	for (unsigned int z = 0; z < samplesPerSide; ++z)
+	{
+		for (unsigned int x = 0; x < samplesPerSide; ++x)
+		{
+			const size_t index = static_cast<size_t>(z) * samplesPerSide + x;
+
+			const uint16_t left = (x > 0) ? quantized[index - 1] : 0;
+			const uint16_t up = (z > 0) ? quantized[index - samplesPerSide] : 0;
+			const uint16_t upLeft = (x > 0 && z > 0) ? quantized[index - samplesPerSide - 1] : 0;
+
+			residuals[index] = ZigZagEncode(static_cast<uint16_t>(quantized[index] - left - up + upLeft));
+		}
+	}
+
+	// Each block keeps its residuals' g_highBits top bits as symbols, the bits below are stored as is
+	std::vector<uint8_t> lowWidths(header.m_blockCount);
+	std::vector<uint8_t> symbols(sampleCount);
+	uint32_t counts[g_symbolCount] = {};
+	size_t lowBitBytes = 0;
+
+	for (uint32_t block = 0; block < header.m_blockCount; ++block)
+	{
+		uint16_t const* values = residuals.data() + static_cast<size_t>(block) * g_blockSize;
+
+		unsigned int width = 0;
+		for (unsigned int i = 0; i < g_blockSize; ++i)
+			width = std::max(width, BitWidth(values[i]));
+
+		lowWidths[block] = static_cast<uint8_t>((width > g_highBits) ? width - g_highBits : 0);
+		lowBitBytes += LowBitBytes(lowWidths[block]);
+
+		const size_t first = static_cast<size_t>(block) * g_blockSize;
+		const size_t last = std::min(first + g_blockSize, sampleCount);
+
+		for (size_t i = first; i < last; ++i)
+		{
+			symbols[i] = static_cast<uint8_t>(residuals[i] >> lowWidths[block]);
+			++counts[symbols[i]];
+		}
+	}
+
+	uint16_t frequencies[g_symbolCount];
+	uint16_t starts[g_symbolCount];
+	NormalizeFrequencies(counts, sampleCount, frequencies);
+
+	for (unsigned int symbol = 0, start = 0; symbol < g_symbolCount; start += frequencies[symbol++])
+		starts[symbol] = static_cast<uint16_t>(start);
+
+	// rANS is last in first out, symbols are encoded backwards from the end of the buffer
+	std::vector<std::byte> ransBytes(sampleCount * 2 + g_ransStateCount * sizeof(uint32_t));
+	std::byte* ransEnd = ransBytes.data() + ransBytes.size();
+	std::byte* ransPointer = ransEnd;
+	uint32_t states[g_ransStateCount];
+	std::fill_n(states, g_ransStateCount, g_ransLow);
+
+	for (size_t i = sampleCount; i-- > 0;)
+	{
+		uint32_t& state = states[i % g_ransStateCount];
+		const uint32_t frequency = frequencies[symbols[i]];
+		const uint32_t stateMax = ((g_ransLow >> g_probabilityBits) << 16) * frequency;
+
+		if (state >= stateMax)
+		{
+			ransPointer -= sizeof(uint16_t);
+			Store16(ransPointer, static_cast<uint16_t>(state));
+			state >>= 16;
+		}
+
+		state = ((state / frequency) << g_probabilityBits) + (state % frequency) + starts[symbols[i]];
+	}
+
+	// The decoder reads state 0 first
+	for (unsigned int i = g_ransStateCount; i-- > 0;)
+	{
+		ransPointer -= sizeof(uint32_t);
+		Store32(ransPointer, states[i]);
+	}
+
+	header.m_ransBytes = static_cast<uint32_t>(ransEnd - ransPointer);
+
+	const StreamLayout layout = MakeLayout(header, lowBitBytes);
+	output.assign(layout.m_end, std::byte(0));
+
+	std::memcpy(output.data(), &header, sizeof(EncodedTileHeader));
+	std::memcpy(output.data() + layout.m_frequencies, frequencies, sizeof(frequencies));
+	std::memcpy(output.data() + layout.m_widths, lowWidths.data(), lowWidths.size());
+	std::memcpy(output.data() + layout.m_rans, ransPointer, header.m_ransBytes);
+
+	std::byte* lowBits = output.data() + layout.m_lowBits;
+
+	for (uint32_t block = 0; block < header.m_blockCount; ++block)
+	{
+		PackLowBits(residuals.data() + static_cast<size_t>(block) * g_blockSize, lowWidths[block], lowBits);
+		lowBits += LowBitBytes(lowWidths[block]);
+	}
+}
+
+bool src::codec::DecodeHeights(const std::byte* data, size_t size, float* heights, unsigned int samplesPerSide)
+{
+	if (size < sizeof(EncodedTileHeader))
+		return false;
+
+	EncodedTileHeader header;
+	std::memcpy(&header, data, sizeof(EncodedTileHeader));
+
+	const size_t sampleCount = static_cast<size_t>(samplesPerSide) * samplesPerSide;
+
+	if (header.m_samplesPerSide != samplesPerSide ||
+		header.m_blockCount != (sampleCount + g_blockSize - 1) / g_blockSize ||
+		header.m_quantizationSteps == 0 || header.m_quantizationSteps > 0xFFFF ||
+		header.m_ransBytes < g_ransStateCount * sizeof(uint32_t) || header.m_ransBytes % sizeof(uint16_t) != 0)
+		return false;
+
+	// Block widths are needed to find where the rANS bytes start
+	const StreamLayout widthLayout = MakeLayout(header, 0);
+
+	if (widthLayout.m_end > size)
+		return false;
+
+	uint8_t const* lowWidths = reinterpret_cast<uint8_t const*>(data + widthLayout.m_widths);
+	size_t lowBitBytes = 0;
+
+	for (uint32_t block = 0; block < header.m_blockCount; ++block)
+	{
+		if (lowWidths[block] > 16 - g_highBits)
+			return false;
+
+		lowBitBytes += LowBitBytes(lowWidths[block]);
+	}
+
+	const StreamLayout layout = MakeLayout(header, lowBitBytes);
+
+	if (layout.m_end != size)
+		return false;
+
+	uint16_t frequencies[g_symbolCount];
+	std::memcpy(frequencies, data + layout.m_frequencies, sizeof(frequencies));
+
+	// Slot of the probability range -> symbol
+	SlotEntry slots[g_probabilityTotal];
+	uint32_t frequencyTotal = 0;
+
+	for (unsigned int symbol = 0; symbol < g_symbolCount; ++symbol)
+	{
+		if (frequencyTotal + frequencies[symbol] > g_probabilityTotal)
+			return false;
+
+		for (uint32_t slot = 0; slot < frequencies[symbol]; ++slot)
+			slots[frequencyTotal + slot] = {frequencies[symbol], static_cast<uint16_t>(slot), static_cast<uint8_t>(symbol)};
+
+		frequencyTotal += frequencies[symbol];
+	}
+
+	if (frequencyTotal != g_probabilityTotal)
+		return false;
+
+	// Low bits first, the entropy coded high bits are then added on top
+	std::vector<uint16_t> residuals(static_cast<size_t>(header.m_blockCount) * g_blockSize);
+	const std::byte* lowBits = data + layout.m_lowBits;
+
+	for (uint32_t block = 0; block < header.m_blockCount; ++block)
+	{
+		UnpackLowBits(lowBits, lowWidths[block], residuals.data() + static_cast<size_t>(block) * g_blockSize);
+		lowBits += LowBitBytes(lowWidths[block]);
+	}
+
+	const std::byte* ransPointer = data + layout.m_rans;
+	const std::byte* ransEnd = data + layout.m_end;
+	uint32_t states[g_ransStateCount];
+
+	for (uint32_t& state : states)
+	{
+		state = Load32(ransPointer);
+		ransPointer += sizeof(uint32_t);
+	}
+
+	// The bounds checked loop takes over for the last words of the stream
+	const std::byte* ransFastEnd = ransEnd - std::min<size_t>(ransEnd - ransPointer, g_ransStateCount * sizeof(uint16_t));
+	size_t i = 0;
+
+	for (uint32_t block = 0; block < header.m_blockCount; ++block)
+	{
+		const unsigned int lowWidth = lowWidths[block];
+		const size_t blockEnd = std::min<size_t>(i + g_blockSize, sampleCount) & ~static_cast<size_t>(g_ransStateCount - 1);
+
+		// Refills are selects rather than branches, whether a state needs one is close to random
+		for (; i < blockEnd && ransPointer <= ransFastEnd; i += g_ransStateCount)
+		{
+			for (unsigned int lane = 0; lane < g_ransStateCount; ++lane)
+			{
+				SlotEntry const& entry = slots[states[lane] & (g_probabilityTotal - 1)];
+
+				residuals[i + lane] = static_cast<uint16_t>(residuals[i + lane] | (entry.m_symbol << lowWidth));
+				states[lane] = entry.m_frequency * (states[lane] >> g_probabilityBits) + entry.m_bias;
+
+				const bool isRefill = states[lane] < g_ransLow;
+				states[lane] = isRefill ? (states[lane] << 16) | Load16(ransPointer) : states[lane];
+				ransPointer += isRefill ? sizeof(uint16_t) : 0;
+			}
+		}
+
+		// Tail of the tile and the end of the stream
+		for (const size_t end = std::min<size_t>(static_cast<size_t>(block + 1) * g_blockSize, sampleCount); i < end; ++i)
+		{
+			uint32_t& state = states[i % g_ransStateCount];
+			SlotEntry const& entry = slots[state & (g_probabilityTotal - 1)];
+
+			residuals[i] = static_cast<uint16_t>(residuals[i] | (entry.m_symbol << lowWidth));
+			state = entry.m_frequency * (state >> g_probabilityBits) + entry.m_bias;
+
+			// A corrupt stream may ask for more words than there are, it is caught below
+			if (state < g_ransLow && ransPointer < ransEnd)
+			{
+				state = (state << 16) | Load16(ransPointer);
+				ransPointer += sizeof(uint16_t);
+			}
+		}
+	}
+
+	// Every byte consumed and all states back to where the encoder started
+	if (ransPointer != ransEnd || std::any_of(states, states + g_ransStateCount, [](uint32_t state) { return state != g_ransLow; }))
+		return false;
+
+	const float step = (header.m_max - header.m_min) / static_cast<float>(header.m_quantizationSteps);
+	std::vector<uint16_t> previousRow(samplesPerSide, 0);
+
+	for (unsigned int z = 0; z < samplesPerSide; ++z)
+	{
+		const size_t rowOffset = static_cast<size_t>(z) * samplesPerSide;
+		DecodeRow(residuals.data() + rowOffset, previousRow.data(), heights + rowOffset, samplesPerSide, header.m_min, step);
+	}
+
+	return true;
+}
@@ -0,0 +1,223 @@
+#include "terrain/TileStreamer.h"
+#include "terrain/TileCache.h"
+#include "terrain/TileArchive.h"
+#include "terrain/HeightField.h"
+#include "utility/Ray.h"
+#include "utility/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+
+src::TileStreamer::TileStreamer(TileCache& cache, TileSettings const& settings, int radius, unsigned int maxGeneratedPerUpdate)
+	: m_cache(cache), m_settings(settings), m_archive(nullptr), m_threadPool(nullptr), m_radius(radius), m_maxGeneratedPerUpdate(maxGeneratedPerUpdate)
+{
+}
+
+src::TileStreamer::~TileStreamer(void)
+{
+	// Workers reference the streamer, wait for the tiles still in flight
+	{
+		std::unique_lock lock(m_completedMutex);
+		m_completedCondition.wait(lock, [this]
+		{
+			return m_completedTiles.size() == m_pendingTiles.size();
+		});
+	}
+
+	for (auto const& tile : m_residentTiles)
+		m_cache.Release(tile.first);
+}
+
+void src::TileStreamer::Update(math::Vector3<double> const& position)
+{
+	const double tileSize = static_cast<double>(TileWorldSize(m_settings, 0));
+	const int centerX = static_cast<int>(std::floor(position[0] / tileSize));
+	const int centerZ = static_cast<int>(std::floor(position[2] / tileSize));
+
+	// Unpin tiles which left the streaming area, they stay cached until evicted
+	for (auto it = m_residentTiles.begin(); it != m_residentTiles.end();)
+	{
+		if (!IsInArea(it->first, centerX, centerZ))
+		{
+			m_cache.Release(it->first);
+			it = m_residentTiles.erase(it);
+		}
+		else
+			++it;
+	}
+
+	CollectCompletedTiles(centerX, centerZ);
+
+	// Collect missing tiles, closest first so the area around the camera fills in first
+	std::vector<TileKey> missingTiles;
+
+	for (int z = centerZ - m_radius; z <= centerZ + m_radius; ++z)
+	{
+		for (int x = centerX - m_radius; x <= centerX + m_radius; ++x)
+		{
+			TileKey key = TileKey::Make(m_settings, 0, x, z);
+
+			if (!m_residentTiles.contains(key) && !m_pendingTiles.contains(key))
+				missingTiles.push_back(key);
+		}
+	}
+
+	std::sort(missingTiles.begin(), missingTiles.end(), [centerX, centerZ](TileKey const& lhs, TileKey const& rhs)
+	{
+		const int lhsDistance = std::max(std::abs(lhs.m_x - centerX), std::abs(lhs.m_z - centerZ));
+		const int rhsDistance = std::max(std::abs(rhs.m_x - centerX), std::abs(rhs.m_z - centerZ));
+
+		return lhsDistance < rhsDistance;
+	});
+
+	// Tiles in flight count against the limit, so workers never queue more than it
+	unsigned int generatedCount = static_cast<unsigned int>(m_pendingTiles.size());
+
+	for (TileKey const& key : missingTiles)
+	{
+		// Cached tiles are free, generation is limited to avoid frame spikes / flooding the pool
+		if (!m_cache.Contains(key))
+		{
+			if (generatedCount >= m_maxGeneratedPerUpdate)
+				continue;
+
+			++generatedCount;
+
+			if (m_threadPool)
+			{
+				m_pendingTiles.insert(key);
+				m_threadPool->Submit([this, key]
+				{
+					std::shared_ptr<HeightField> tile;
+
+					// A failed tile still completes (null) or the destructor would wait for it forever
+					try
+					{
+						tile = LoadTile(key);
+					}
+					catch (std::exception const& exception)
+					{
+						std::printf("Failed to load tile %d %d: %s\n", key.m_x, key.m_z, exception.what());
+					}
+					catch (...)
+					{
+						std::printf("Failed to load tile %d %d\n", key.m_x, key.m_z);
+					}
+
+					// Notified under the lock, the destructor can't see the tile and destroy the
+					// condition before this worker is done with it
+					std::lock_guard lock(m_completedMutex);
+					m_completedTiles.emplace_back(key, std::move(tile));
+					m_completedCondition.notify_all();
+				});
+
+				continue;
+			}
+		}
+
+		auto tile = m_cache.Acquire(key, [this](TileKey const& tileKey)
+		{
+			return LoadTile(tileKey);
+		});
+
+		if (tile)
+			m_residentTiles.emplace(key, std::move(tile));
+	}
+}
+
+void src::TileStreamer::SetArchive(TileArchive const* archive) noexcept
+{
+	m_archive = archive;
+}
+
+void src::TileStreamer::SetThreadPool(ThreadPool* threadPool) noexcept
+{
+	m_threadPool = threadPool;
+}
+
+src::HeightField const* src::TileStreamer::FindTile(float worldX, float worldZ) const
+{
+	const float tileSize = TileWorldSize(m_settings, 0);
+	const int tileX = static_cast<int>(std::floor(worldX / tileSize));
+	const int tileZ = static_cast<int>(std::floor(worldZ / tileSize));
+
+	auto it = m_residentTiles.find(TileKey::Make(m_settings, 0, tileX, tileZ));
+
+	return (it != m_residentTiles.end()) ? it->second.get() : nullptr;
+}
+
+bool src::TileStreamer::Raycast(Ray const& ray, float maxDistance, RayHit& hit) const
+{
+	hit.m_hit = false;
+
+	// Each tile only reports hits closer than the best one so far
+	for (auto const& tile : m_residentTiles)
+	{
+		RayHit tileHit;
+
+		if (tile.second->Raycast(ray, maxDistance, tileHit))
+		{
+			hit = tileHit;
+			maxDistance = tileHit.m_distance;
+		}
+	}
+
+	return hit.m_hit;
+}
+
+src::TileSettings const& src::TileStreamer::GetSettings(void) const noexcept
+{
+	return m_settings;
+}
+
+std::shared_ptr<src::HeightField> src::TileStreamer::LoadTile(TileKey const& key) const
+{
+	if (m_archive)
+	{
+		if (std::shared_ptr<HeightField> bakedTile = m_archive->LoadTile(key))
+			return bakedTile;
+	}
+
+	return GenerateTile(key, m_settings);
+}
+
+void src::TileStreamer::CollectCompletedTiles(int centerX, int centerZ)
+{
+	std::vector<CompletedTile> completedTiles;
+
+	{
+		std::lock_guard lock(m_completedMutex);
+		completedTiles.swap(m_completedTiles);
+	}
+
+	for (CompletedTile& completed : completedTiles)
+	{
+		m_pendingTiles.erase(completed.first);
+
+		if (!completed.second)
+			continue;
+
+		// Tiles the camera moved away from are only cached
+		if (!IsInArea(completed.first, centerX, centerZ))
+		{
+			m_cache.Insert(completed.first, std::move(completed.second));
+			continue;
+		}
+
+		// Pins the tile, an equal tile already cached is kept instead
+		auto tile = m_cache.Acquire(completed.first, [&completed](TileKey const&)
+		{
+			return completed.second;
+		});
+
+		if (tile)
+			m_residentTiles.emplace(completed.first, std::move(tile));
+	}
+}
+
+bool src::TileStreamer::IsInArea(TileKey const& key, int centerX, int centerZ) const noexcept
+{
+	return std::abs(key.m_x - centerX) <= m_radius && std::abs(key.m_z - centerZ) <= m_radius;
+}
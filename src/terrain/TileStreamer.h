@@ -0,0 +1,79 @@
+#pragma once
+
+#include "terrain/Tile.h"
+
+#include "LibMath/vector/Vector3.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace src
+{
+	class HeightField;
+	class TileArchive;
+	class TileCache;
+	class ThreadPool;
+	struct Ray;
+	struct RayHit;
+
+	/*
+	*	Keeps the LOD 0 tiles around a position resident (pinned) in a TileCache.
+	*	Tiles leaving the area are unpinned but stay cached, so coming back only costs a lookup.
+	*
+	*	With a thread pool, missing tiles are loaded / generated by its workers and picked up by a
+	*	later Update, at most 'maxGeneratedPerUpdate' at a time. Without one they are generated in Update.
+	*/
+	class TileStreamer
+	{
+	public:
+		TileStreamer(void) = delete;
+		TileStreamer(TileCache& cache, TileSettings const& settings, int radius, unsigned int maxGeneratedPerUpdate);
+		TileStreamer(TileStreamer const&) = delete;
+		TileStreamer& operator=(TileStreamer const&) = delete;
+		~TileStreamer(void);
+
+		void Update(math::Vector3<double> const& position);
+
+		// Baked tiles found in the archive are loaded instead of being generated
+		void SetArchive(TileArchive const* archive) noexcept;
+
+		// Must be set before the first Update and outlive the streamer
+		void SetThreadPool(ThreadPool* threadPool) noexcept;
+
+		// Resident tile containing the world position, null if not streamed in yet
+		HeightField const* FindTile(float worldX, float worldZ) const;
+
+		// Closest hit against the resident tiles, areas not streamed in yet are skipped
+		bool Raycast(Ray const& ray, float maxDistance, RayHit& hit) const;
+
+		TileSettings const& GetSettings(void) const noexcept;
+
+	private:
+		using CompletedTile = std::pair<TileKey, std::shared_ptr<HeightField>>;
+
+		std::shared_ptr<HeightField> LoadTile(TileKey const& key) const;
+		void CollectCompletedTiles(int centerX, int centerZ);
+		bool IsInArea(TileKey const& key, int centerX, int centerZ) const noexcept;
+
+		TileCache&															m_cache;
+		TileSettings														m_settings;
+		TileArchive const*													m_archive;
+		ThreadPool*															m_threadPool;
+		std::unordered_map<TileKey, std::shared_ptr<HeightField>, TileKeyHash>	m_residentTiles;
+		int																	m_radius;
+		unsigned int														m_maxGeneratedPerUpdate;
+
+		// Tiles submitted to the thread pool, only touched by the thread calling Update
+		std::unordered_set<TileKey, TileKeyHash>							m_pendingTiles;
+
+		// Filled by the workers
+		std::vector<CompletedTile>											m_completedTiles;
+		std::mutex															m_completedMutex;
+		std::condition_variable												m_completedCondition;
+	};
+}
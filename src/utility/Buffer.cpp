@@ -2,11 +2,26 @@
 
 #include "glad/glad.h"
 
+#include <utility>
+
 src::Buffer::Buffer(void)
 {
 	glCreateBuffers(1, &m_buffer);
 }
 
+src::Buffer::Buffer(Buffer&& other) noexcept
+	: m_buffer(other.m_buffer)
+{
+	other.m_buffer = 0;
+}
+
+src::Buffer& src::Buffer::operator=(Buffer&& other) noexcept
+{
+	std::swap(m_buffer, other.m_buffer);
+
+	return *this;
+}
+
 src::Buffer::~Buffer(void)
 {
 	glDeleteBuffers(1, &m_buffer);
@@ -23,6 +38,11 @@ void src::Buffer::SetData(void* data, size_t size, unsigned int offset)
 	glNamedBufferSubData(m_buffer, offset, size, data);
 }
 
+void src::Buffer::SetStorage(const void* data, size_t size, unsigned int flags)
+{
+	glNamedBufferStorage(m_buffer, size, data, flags);
+}
+
 void src::Buffer::DeleteData(void)
 {
 	glDeleteBuffers(1, &m_buffer);
@@ -1,15 +1,25 @@
 #pragma once
 
+#include <cstddef>
+
 namespace src
 {
 	class Buffer
 	{
 	public:
 		Buffer(void);
+		Buffer(Buffer const&) = delete;
+		Buffer(Buffer&& other) noexcept;
+		Buffer& operator=(Buffer const&) = delete;
+		Buffer& operator=(Buffer&& other) noexcept;
 		~Buffer(void);
 
 		void SetData(void* data, size_t size);
 		void SetData(void* data, size_t size, unsigned int offset);
+
+		// Immutable storage (glNamedBufferStorage), contents can still be updated with SetData + offset
+		// when flags contain GL_DYNAMIC_STORAGE_BIT
+		void SetStorage(const void* data, size_t size, unsigned int flags);
 		void DeleteData(void);
 
 		operator unsigned int(void) const noexcept;
@@ -18,4 +28,4 @@ namespace src
 	};
 
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,185 @@
+#include "utility/BufferAllocator.h"
+
+#include "glad/glad.h"
+
+#include <cstdio>
+
+src::BufferAllocator::BufferAllocator(uint64_t arenaSize)
+	: m_arenaSize(arenaSize), m_allocatedBytes(0)
+{
+}
+
+src::BufferAllocation src::BufferAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+	BufferAllocation allocation;
+
+	if (size == 0)
+		return allocation;
+
+	if (alignment == 0)
+		alignment = 1;
+
+	uint64_t offset = 0;
+
+	for (uint32_t i = 0; i < m_arenas.size(); ++i)
+	{
+		if (AllocateFrom(*m_arenas[i], size, alignment, offset))
+		{
+			allocation.m_arena = i;
+			break;
+		}
+
+		allocation.m_arena = i + 1;
+	}
+
+	// No arena has room, oversized requests get an arena of their own
+	if (allocation.m_arena == m_arenas.size())
+	{
+		auto arena = std::make_unique<Arena>();
+		arena->m_size = (size > m_arenaSize) ? size : m_arenaSize;
+		arena->m_buffer.SetStorage(nullptr, static_cast<size_t>(arena->m_size), GL_DYNAMIC_STORAGE_BIT);
+
+		AddFreeRange(*arena, 0, arena->m_size);
+
+		if (!AllocateFrom(*arena, size, alignment, offset))
+		{
+			std::printf("Failed to allocate %llu bytes of buffer memory.\n", static_cast<unsigned long long>(size));
+			return allocation;
+		}
+
+		m_arenas.push_back(std::move(arena));
+	}
+
+	allocation.m_buffer = m_arenas[allocation.m_arena]->m_buffer;
+	allocation.m_offset = offset;
+	allocation.m_size = size;
+
+	m_allocatedBytes += size;
+
+	return allocation;
+}
+
+void src::BufferAllocator::Free(BufferAllocation& allocation)
+{
+	if (!allocation.IsValid())
+		return;
+
+	if (allocation.m_arena >= m_arenas.size() || m_arenas[allocation.m_arena]->m_buffer != allocation.m_buffer)
+	{
+		std::printf("Failed to free buffer allocation, allocation does not belong to this allocator.\n");
+		return;
+	}
+
+	AddFreeRange(*m_arenas[allocation.m_arena], allocation.m_offset, allocation.m_size);
+	m_allocatedBytes -= allocation.m_size;
+
+	allocation = BufferAllocation();
+}
+
+void src::BufferAllocator::Upload(BufferAllocation const& allocation, const void* data, uint64_t size, uint64_t offset) const
+{
+	if (!allocation.IsValid() || offset + size > allocation.m_size)
+	{
+		std::printf("Failed to upload buffer data, range is outside of the allocation.\n");
+		return;
+	}
+
+	glNamedBufferSubData(allocation.m_buffer, static_cast<GLintptr>(allocation.m_offset + offset), static_cast<GLsizeiptr>(size), data);
+}
+
+uint32_t src::BufferAllocator::GetArenaCount(void) const noexcept
+{
+	return static_cast<uint32_t>(m_arenas.size());
+}
+
+unsigned int src::BufferAllocator::GetArenaBuffer(uint32_t arena) const noexcept
+{
+	return (arena < m_arenas.size()) ? static_cast<unsigned int>(m_arenas[arena]->m_buffer) : 0;
+}
+
+uint64_t src::BufferAllocator::GetAllocatedBytes(void) const noexcept
+{
+	return m_allocatedBytes;
+}
+
+bool src::BufferAllocator::AllocateFrom(Arena& arena, uint64_t size, uint64_t alignment, uint64_t& offset)
+{
+	// Best fit, the smallest ranges large enough are tried first until one fits once aligned
+	for (auto it = arena.m_freeBySize.lower_bound(size); it != arena.m_freeBySize.end(); ++it)
+	{
+		const uint64_t rangeSize = it->first;
+		const uint64_t rangeOffset = it->second;
+		const uint64_t alignedOffset = (rangeOffset + alignment - 1) / alignment * alignment;
+		const uint64_t padding = alignedOffset - rangeOffset;
+
+		if (padding + size > rangeSize)
+			continue;
+
+		RemoveFreeRange(arena, rangeOffset, rangeSize);
+
+		// Return the unused head and tail of the range
+		if (padding > 0)
+			AddFreeRange(arena, rangeOffset, padding);
+
+		if (padding + size < rangeSize)
+			AddFreeRange(arena, alignedOffset + size, rangeSize - padding - size);
+
+		offset = alignedOffset;
+
+		return true;
+	}
+
+	return false;
+}
+
+void src::BufferAllocator::AddFreeRange(Arena& arena, uint64_t offset, uint64_t size)
+{
+	// Merge with the following range
+	auto next = arena.m_freeByOffset.lower_bound(offset);
+
+	if (next != arena.m_freeByOffset.end() && next->first == offset + size)
+	{
+		const uint64_t nextOffset = next->first;
+		const uint64_t nextSize = next->second;
+
+		RemoveFreeRange(arena, nextOffset, nextSize);
+		size += nextSize;
+	}
+
+	// Merge with the preceding range
+	auto previous = arena.m_freeByOffset.lower_bound(offset);
+
+	if (previous != arena.m_freeByOffset.begin())
+	{
+		--previous;
+
+		if (previous->first + previous->second == offset)
+		{
+			const uint64_t previousOffset = previous->first;
+			const uint64_t previousSize = previous->second;
+
+			RemoveFreeRange(arena, previousOffset, previousSize);
+			offset = previousOffset;
+			size += previousSize;
+		}
+	}
+
+	arena.m_freeByOffset.emplace(offset, size);
+	arena.m_freeBySize.emplace(size, offset);
+}
+
+void src::BufferAllocator::RemoveFreeRange(Arena& arena, uint64_t offset, uint64_t size)
+{
+	arena.m_freeByOffset.erase(offset);
+
+	auto range = arena.m_freeBySize.equal_range(size);
+
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (it->second == offset)
+		{
+			arena.m_freeBySize.erase(it);
+			return;
+		}
+	}
+}
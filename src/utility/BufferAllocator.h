@@ -0,0 +1,67 @@
+#pragma once
+
+#include "utility/Buffer.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace src
+{
+	struct BufferAllocation
+	{
+		bool IsValid(void) const noexcept
+		{
+			return m_buffer != 0;
+		}
+
+		unsigned int	m_buffer = 0;
+		uint32_t		m_arena = 0;
+		uint64_t		m_offset = 0; // Bytes from the start of m_buffer
+		uint64_t		m_size = 0;
+	};
+
+	/*
+	*	Sub-allocates ranges of a few large immutable GL buffers (arenas), so many meshes share
+	*	the same buffer objects. Free ranges are kept per arena, allocation is best fit and freed
+	*	ranges are merged with their neighbours.
+	*	Render thread only, like every other GL call.
+	*/
+	class BufferAllocator
+	{
+	public:
+		BufferAllocator(void) = delete;
+		BufferAllocator(uint64_t arenaSize);
+		BufferAllocator(BufferAllocator const&) = delete;
+		BufferAllocator& operator=(BufferAllocator const&) = delete;
+		~BufferAllocator(void) = default;
+
+		// Alignment does not need to be a power of two, vertex ranges can be aligned to the vertex size
+		BufferAllocation Allocate(uint64_t size, uint64_t alignment = 4);
+		void Free(BufferAllocation& allocation);
+
+		void Upload(BufferAllocation const& allocation, const void* data, uint64_t size, uint64_t offset = 0) const;
+
+		uint32_t		GetArenaCount(void) const noexcept;
+		unsigned int	GetArenaBuffer(uint32_t arena) const noexcept;
+		uint64_t		GetAllocatedBytes(void) const noexcept;
+
+	private:
+		struct Arena
+		{
+			Buffer							m_buffer;
+			uint64_t						m_size = 0;
+			std::map<uint64_t, uint64_t>	m_freeByOffset;	// Offset -> size
+			std::multimap<uint64_t, uint64_t>	m_freeBySize;	// Size -> offset
+		};
+
+		bool AllocateFrom(Arena& arena, uint64_t size, uint64_t alignment, uint64_t& offset);
+		void AddFreeRange(Arena& arena, uint64_t offset, uint64_t size);
+		void RemoveFreeRange(Arena& arena, uint64_t offset, uint64_t size);
+
+		std::vector<std::unique_ptr<Arena>>	m_arenas;
+		uint64_t							m_arenaSize;
+		uint64_t							m_allocatedBytes;
+	};
+}
@@ -0,0 +1,173 @@
+#include "utility/File.h"
+
+#include <utility>
+
+#ifdef _WIN32
+	#include <io.h>
+#else
+	#include <unistd.h>
+#endif
+
+src::File::File(File&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+src::File& src::File::operator=(File&& other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+		std::swap(m_file, other.m_file);
+	}
+
+	return *this;
+}
+
+src::File::~File(void)
+{
+	Close();
+}
+
+bool src::File::Open(const char* filePath, EFileMode mode)
+{
+	Close();
+
+	const char* modeString = "rb";
+
+	switch (mode)
+	{
+	case FILE_READ:
+		modeString = "rb";
+		break;
+	case FILE_WRITE:
+		modeString = "w+b";
+		break;
+	case FILE_READ_WRITE:
+		modeString = "r+b";
+		break;
+	}
+
+#ifdef _MSC_VER
+	fopen_s(&m_file, filePath, modeString);
+#else
+	m_file = std::fopen(filePath, modeString);
+#endif
+
+	if (!m_file)
+	{
+		std::printf("Failed to open file '%s'.\n", filePath);
+		return false;
+	}
+
+	return true;
+}
+
+void src::File::Close(void) noexcept
+{
+	if (m_file)
+		std::fclose(m_file);
+
+	m_file = nullptr;
+}
+
+size_t src::File::Read(void* buffer, size_t size)
+{
+	if (!m_file)
+		return 0;
+
+	return std::fread(buffer, 1, size, m_file);
+}
+
+bool src::File::ReadAt(uint64_t offset, void* buffer, size_t size)
+{
+	return Seek(offset) && Read(buffer, size) == size;
+}
+
+bool src::File::Write(const void* data, size_t size)
+{
+	if (!m_file)
+		return false;
+
+	return std::fwrite(data, 1, size, m_file) == size;
+}
+
+bool src::File::WriteAt(uint64_t offset, const void* data, size_t size)
+{
+	return Seek(offset) && Write(data, size);
+}
+
+bool src::File::Seek(uint64_t offset)
+{
+	if (!m_file)
+		return false;
+
+	// 64 bit offsets, fseek is limited to long which is 32 bits on Windows
+#ifdef _WIN32
+	return _fseeki64(m_file, static_cast<long long>(offset), SEEK_SET) == 0;
+#else
+	return fseeko(m_file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+bool src::File::Sync(void)
+{
+	// Flush user space buffers then ask the OS to persist the file
+	if (!m_file || std::fflush(m_file) != 0)
+		return false;
+
+#ifdef _WIN32
+	return _commit(_fileno(m_file)) == 0;
+#else
+	return fsync(fileno(m_file)) == 0;
+#endif
+}
+
+bool src::File::IsOpen(void) const noexcept
+{
+	return m_file != nullptr;
+}
+
+uint64_t src::File::GetPosition(void) const
+{
+	if (!m_file)
+		return 0;
+
+#ifdef _WIN32
+	const long long position = _ftelli64(m_file);
+#else
+	const off_t position = ftello(m_file);
+#endif
+
+	return (position < 0) ? 0 : static_cast<uint64_t>(position);
+}
+
+uint64_t src::File::GetSize(void) const
+{
+	if (!m_file)
+		return 0;
+
+	// Stream position is restored so reads can continue where they were
+	const uint64_t position = GetPosition();
+	uint64_t size = 0;
+
+#ifdef _WIN32
+	if (_fseeki64(m_file, 0, SEEK_END) == 0)
+	{
+		const long long end = _ftelli64(m_file);
+		size = (end < 0) ? 0 : static_cast<uint64_t>(end);
+	}
+
+	_fseeki64(m_file, static_cast<long long>(position), SEEK_SET);
+#else
+	if (fseeko(m_file, 0, SEEK_END) == 0)
+	{
+		const off_t end = ftello(m_file);
+		size = (end < 0) ? 0 : static_cast<uint64_t>(end);
+	}
+
+	fseeko(m_file, static_cast<off_t>(position), SEEK_SET);
+#endif
+
+	return size;
+}
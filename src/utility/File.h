@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace src
+{
+	enum EFileMode : unsigned char
+	{
+		FILE_READ,			// Existing file, read only
+		FILE_WRITE,			// Created or truncated, read and write
+		FILE_READ_WRITE		// Existing file, read and write
+	};
+
+	/*
+	*	Streaming access to a file, closed on destruction.
+	*	Reads go straight into caller provided buffers so large files can be processed in chunks,
+	*	use MappedFile instead when the whole file is needed at once.
+	*/
+	class File
+	{
+	public:
+		File(void) = default;
+		File(File const&) = delete;
+		File(File&& other) noexcept;
+		File& operator=(File const&) = delete;
+		File& operator=(File&& other) noexcept;
+		~File(void);
+
+		bool Open(const char* filePath, EFileMode mode);
+		void Close(void) noexcept;
+
+		// Number of bytes read, less than size only at the end of the file or on error
+		size_t	Read(void* buffer, size_t size);
+		bool	ReadAt(uint64_t offset, void* buffer, size_t size);
+		bool	Write(const void* data, size_t size);
+		bool	WriteAt(uint64_t offset, const void* data, size_t size);
+
+		bool	Seek(uint64_t offset);
+		bool	Sync(void);
+
+		bool		IsOpen(void) const noexcept;
+		uint64_t	GetPosition(void) const;
+		uint64_t	GetSize(void) const;
+
+	private:
+		FILE* m_file = nullptr;
+	};
+}
@@ -0,0 +1,129 @@
+#include "utility/FileWatcher.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+	#include <sys/inotify.h>
+	#include <unistd.h>
+#endif
+
+src::FileWatcher::FileWatcher(void)
+	: m_lastPoll(std::chrono::steady_clock::now()), m_inotify(-1)
+{
+#ifdef __linux__
+	m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (m_inotify < 0)
+		std::printf("Failed to initialize inotify, falling back to polling.\n");
+#endif
+}
+
+src::FileWatcher::~FileWatcher(void)
+{
+#ifdef __linux__
+	if (m_inotify >= 0)
+		close(m_inotify);
+#endif
+}
+
+bool src::FileWatcher::Watch(std::string const& filePath)
+{
+	std::error_code error;
+	const std::filesystem::path path = std::filesystem::absolute(filePath, error);
+
+	if (error || !std::filesystem::exists(path, error))
+	{
+		std::printf("Failed to watch file '%s', file does not exist.\n", filePath.c_str());
+		return false;
+	}
+
+	WatchedFile file;
+	file.m_path = filePath;
+	file.m_fileName = path.filename();
+	file.m_lastWriteTime = std::filesystem::last_write_time(path, error);
+	file.m_watchDescriptor = -1;
+
+#ifdef __linux__
+	// Adding the same directory twice returns the same descriptor
+	if (m_inotify >= 0)
+	{
+		file.m_watchDescriptor = inotify_add_watch(m_inotify, path.parent_path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+
+		// Typically the watch limit (ENOSPC), the file is polled instead
+		if (file.m_watchDescriptor < 0)
+			std::printf("Failed to add inotify watch for '%s' (%s), falling back to polling.\n", filePath.c_str(), std::strerror(errno));
+	}
+#endif
+
+	m_files.push_back(std::move(file));
+
+	return true;
+}
+
+std::vector<std::string> src::FileWatcher::PollChanges(void)
+{
+	std::vector<std::string> changes;
+
+	auto addChange = [&changes](std::string const& path)
+	{
+		if (std::find(changes.begin(), changes.end(), path) == changes.end())
+			changes.push_back(path);
+	};
+
+#ifdef __linux__
+	if (m_inotify >= 0)
+	{
+		alignas(inotify_event) char buffer[4096];
+		ssize_t length;
+
+		while ((length = read(m_inotify, buffer, sizeof(buffer))) > 0)
+		{
+			for (ssize_t offset = 0; offset < length;)
+			{
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+				if (event->len == 0)
+					continue;
+
+				for (WatchedFile const& file : m_files)
+				{
+					if (file.m_watchDescriptor >= 0 && file.m_watchDescriptor == event->wd && file.m_fileName == event->name)
+						addChange(file.m_path);
+				}
+			}
+		}
+	}
+#endif
+
+	// Fallback for files without a watch, compare modification times
+	if (std::none_of(m_files.begin(), m_files.end(), [](WatchedFile const& file) { return file.m_watchDescriptor < 0; }))
+		return changes;
+
+	const auto now = std::chrono::steady_clock::now();
+
+	if (now - m_lastPoll < s_pollInterval)
+		return changes;
+
+	m_lastPoll = now;
+
+	for (WatchedFile& file : m_files)
+	{
+		if (file.m_watchDescriptor >= 0)
+			continue;
+
+		std::error_code error;
+		const auto lastWriteTime = std::filesystem::last_write_time(file.m_path, error);
+
+		if (!error && lastWriteTime != file.m_lastWriteTime)
+		{
+			file.m_lastWriteTime = lastWriteTime;
+			addChange(file.m_path);
+		}
+	}
+
+	return changes;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace src
+{
+	/*
+	*	Reports files modified on disk. Uses inotify on Linux, elsewhere (or when a watch can't be
+	*	added) the modification times are polled at a fixed interval.
+	*	Directories are watched rather than files so editors replacing files on save are detected.
+	*/
+	class FileWatcher
+	{
+	public:
+		FileWatcher(void);
+		FileWatcher(FileWatcher const&) = delete;
+		FileWatcher& operator=(FileWatcher const&) = delete;
+		~FileWatcher(void);
+
+		bool Watch(std::string const& filePath);
+
+		// Files modified since the last call, never blocks
+		std::vector<std::string> PollChanges(void);
+
+	private:
+		static constexpr std::chrono::milliseconds s_pollInterval = std::chrono::milliseconds(250);
+
+		struct WatchedFile
+		{
+			std::string						m_path;
+			std::filesystem::path			m_fileName;
+			std::filesystem::file_time_type	m_lastWriteTime;
+			int								m_watchDescriptor; // -1 when polled
+		};
+
+		std::vector<WatchedFile>				m_files;
+		std::chrono::steady_clock::time_point	m_lastPoll;
+		int										m_inotify;
+	};
+}
@@ -4,6 +4,26 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+namespace
+{
+	using MultiDrawElementsIndirectCountFunc = void (APIENTRYP)(GLenum, GLenum, const void*, GLintptr, GLsizei, GLsizei);
+
+	MultiDrawElementsIndirectCountFunc g_multiDrawElementsIndirectCount = nullptr;
+
+	void LoadOptionalFunctions(void)
+	{
+		GLint major = 0;
+		GLint minor = 0;
+		glGetIntegerv(GL_MAJOR_VERSION, &major);
+		glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+		if (major > 4 || (major == 4 && minor >= 6))
+			g_multiDrawElementsIndirectCount = reinterpret_cast<MultiDrawElementsIndirectCountFunc>(glfwGetProcAddress("glMultiDrawElementsIndirectCount"));
+		else if (glfwExtensionSupported("GL_ARB_indirect_parameters"))
+			g_multiDrawElementsIndirectCount = reinterpret_cast<MultiDrawElementsIndirectCountFunc>(glfwGetProcAddress("glMultiDrawElementsIndirectCountARB"));
+	}
+}
+
 int src::InitGraphicsApi(void)
 {
 	int result = gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
@@ -14,6 +34,8 @@ int src::InitGraphicsApi(void)
 		return -1;
 	}
 
+	LoadOptionalFunctions();
+
 	return 0;
 }
 
@@ -22,3 +44,13 @@ void src::Clear(void)
 	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
+
+bool src::HasMultiDrawIndirectCount(void)
+{
+	return g_multiDrawElementsIndirectCount != nullptr;
+}
+
+void src::MultiDrawElementsIndirectCount(unsigned int mode, unsigned int type, intptr_t indirect, intptr_t drawCount, int maxDrawCount, int stride)
+{
+	g_multiDrawElementsIndirectCount(mode, type, reinterpret_cast<const void*>(indirect), drawCount, maxDrawCount, stride);
+}
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <cstdint>
+
 namespace src
 {
 	int InitGraphicsApi(void);
 	void Clear(void);
+
+	// glMultiDrawElementsIndirectCount (GL 4.6 or ARB_indirect_parameters), not part of the GL 4.5 loader
+	bool HasMultiDrawIndirectCount(void);
+	void MultiDrawElementsIndirectCount(unsigned int mode, unsigned int type, intptr_t indirect, intptr_t drawCount, int maxDrawCount, int stride);
 }
\ No newline at end of file
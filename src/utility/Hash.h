@@ -0,0 +1,59 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+namespace src
+{
+	/*
+	*	64 bit FNV-1a over the little endian bytes of each value. Unlike std::hash the result is
+	*	the same on every platform and standard library, so it can be stored in files.
+	*/
+	class StableHash
+	{
+	public:
+		StableHash(void) = default;
+		~StableHash(void) = default;
+
+		StableHash& Add(uint32_t value) noexcept
+		{
+			for (int i = 0; i < 4; ++i)
+			{
+				m_hash ^= (value >> (8 * i)) & 0xFFu;
+				m_hash *= 0x100000001B3ull;
+			}
+
+			return *this;
+		}
+
+		StableHash& Add(int32_t value) noexcept
+		{
+			return Add(static_cast<uint32_t>(value));
+		}
+
+		StableHash& Add(uint64_t value) noexcept
+		{
+			Add(static_cast<uint32_t>(value));
+			return Add(static_cast<uint32_t>(value >> 32));
+		}
+
+		StableHash& Add(float value) noexcept
+		{
+			// Both zeros are the same parameter
+			return Add(std::bit_cast<uint32_t>(value + 0.0f));
+		}
+
+		StableHash& Add(bool value) noexcept
+		{
+			return Add(static_cast<uint32_t>(value));
+		}
+
+		uint64_t Get(void) const noexcept
+		{
+			return m_hash;
+		}
+
+	private:
+		uint64_t m_hash = 0xCBF29CE484222325ull;
+	};
+}
@@ -0,0 +1,165 @@
+#include "utility/MappedFile.h"
+
+#include <cstdio>
+#include <utility>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+src::MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+src::MappedFile& src::MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+
+		std::swap(m_data, other.m_data);
+		std::swap(m_size, other.m_size);
+
+#ifdef _WIN32
+		std::swap(m_fileHandle, other.m_fileHandle);
+		std::swap(m_mappingHandle, other.m_mappingHandle);
+#else
+		std::swap(m_fileDescriptor, other.m_fileDescriptor);
+#endif
+	}
+
+	return *this;
+}
+
+src::MappedFile::~MappedFile(void)
+{
+	Close();
+}
+
+bool src::MappedFile::Open(const char* filePath)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		std::printf("Failed to map file '%s', file could not be opened.\n", filePath);
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		std::printf("Failed to map file '%s', could not query file size.\n", filePath);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_fileHandle = file;
+	m_size = static_cast<uint64_t>(fileSize.QuadPart);
+
+	// Empty files cannot be mapped, they are valid but have no data
+	if (m_size == 0)
+		return true;
+
+	m_mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (m_mappingHandle)
+		m_data = static_cast<const std::byte*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+	m_fileDescriptor = open(filePath, O_RDONLY);
+
+	if (m_fileDescriptor < 0)
+	{
+		std::printf("Failed to map file '%s', file could not be opened.\n", filePath);
+		return false;
+	}
+
+	struct stat fileStat;
+
+	if (fstat(m_fileDescriptor, &fileStat) != 0)
+	{
+		std::printf("Failed to map file '%s', could not query file size.\n", filePath);
+		Close();
+		return false;
+	}
+
+	m_size = static_cast<uint64_t>(fileStat.st_size);
+
+	// Empty files cannot be mapped, they are valid but have no data
+	if (m_size == 0)
+		return true;
+
+	void* mapping = mmap(nullptr, static_cast<size_t>(m_size), PROT_READ, MAP_SHARED, m_fileDescriptor, 0);
+
+	if (mapping != MAP_FAILED)
+		m_data = static_cast<const std::byte*>(mapping);
+#endif
+
+	if (!m_data)
+	{
+		std::printf("Failed to map file '%s'.\n", filePath);
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void src::MappedFile::Close(void) noexcept
+{
+#ifdef _WIN32
+	if (m_data)
+		UnmapViewOfFile(m_data);
+
+	if (m_mappingHandle)
+		CloseHandle(m_mappingHandle);
+
+	if (m_fileHandle)
+		CloseHandle(m_fileHandle);
+
+	m_mappingHandle = nullptr;
+	m_fileHandle = nullptr;
+#else
+	if (m_data)
+		munmap(const_cast<std::byte*>(m_data), static_cast<size_t>(m_size));
+
+	if (m_fileDescriptor >= 0)
+		close(m_fileDescriptor);
+
+	m_fileDescriptor = -1;
+#endif
+
+	m_data = nullptr;
+	m_size = 0;
+}
+
+bool src::MappedFile::IsOpen(void) const noexcept
+{
+#ifdef _WIN32
+	return m_fileHandle != nullptr;
+#else
+	return m_fileDescriptor >= 0;
+#endif
+}
+
+const std::byte* src::MappedFile::GetData(void) const noexcept
+{
+	return m_data;
+}
+
+uint64_t src::MappedFile::GetSize(void) const noexcept
+{
+	return m_size;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace src
+{
+	// Read only memory mapped view of a whole file, unmapped on destruction
+	class MappedFile
+	{
+	public:
+		MappedFile(void) = default;
+		MappedFile(MappedFile const&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile const&) = delete;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		~MappedFile(void);
+
+		bool Open(const char* filePath);
+		void Close(void) noexcept;
+
+		bool				IsOpen(void) const noexcept;
+		const std::byte*	GetData(void) const noexcept;
+		uint64_t			GetSize(void) const noexcept;
+
+	private:
+		const std::byte*	m_data = nullptr;
+		uint64_t			m_size = 0;
+
+#ifdef _WIN32
+		void*				m_fileHandle = nullptr;
+		void*				m_mappingHandle = nullptr;
+#else
+		int					m_fileDescriptor = -1;
+#endif
+	};
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "LibMath/vector/Vector3.h"
+
+namespace src
+{
+	struct Ray
+	{
+		math::Vector3<float> m_origin;
+		math::Vector3<float> m_direction; // Expected to be normalized
+
+		Ray(math::Vector3<float> origin, math::Vector3<float> direction)
+			: m_origin(origin), m_direction(direction)
+		{}
+
+		Ray(void) = default;
+	};
+
+	struct RayHit
+	{
+		math::Vector3<float>	m_position;
+		float					m_distance = 0.0f;
+		bool					m_hit = false;
+	};
+}
@@ -0,0 +1,117 @@
+#include "utility/RingBuffer.h"
+
+#include "glad/glad.h"
+
+#include <cstdio>
+
+namespace
+{
+	constexpr GLbitfield g_mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	// Nanoseconds, waits are retried so this only bounds each call
+	constexpr GLuint64 g_fenceTimeout = 1000000000;
+}
+
+src::RingBuffer::RingBuffer(uint64_t frameSize, unsigned int frameCount)
+	: m_mappedData(nullptr), m_fences(frameCount, nullptr), m_frameSize(frameSize), m_frameUsed(0),
+	  m_uniformAlignment(256), m_frameCount(frameCount), m_frameIndex(0)
+{
+	GLint uniformAlignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+
+	if (uniformAlignment > 0)
+		m_uniformAlignment = static_cast<uint64_t>(uniformAlignment);
+
+	// Keep every region start aligned for any binding
+	m_frameSize = (m_frameSize + m_uniformAlignment - 1) / m_uniformAlignment * m_uniformAlignment;
+
+	const GLsizeiptr totalSize = static_cast<GLsizeiptr>(m_frameSize * m_frameCount);
+
+	m_buffer.SetStorage(nullptr, static_cast<size_t>(totalSize), g_mapFlags);
+	m_mappedData = static_cast<std::byte*>(glMapNamedBufferRange(m_buffer, 0, totalSize, g_mapFlags));
+
+	if (!m_mappedData)
+		std::printf("Failed to map ring buffer of %lld bytes.\n", static_cast<long long>(totalSize));
+}
+
+src::RingBuffer::~RingBuffer(void)
+{
+	for (void* fence : m_fences)
+	{
+		if (fence)
+			glDeleteSync(static_cast<GLsync>(fence));
+	}
+
+	if (m_mappedData)
+		glUnmapNamedBuffer(m_buffer);
+}
+
+void src::RingBuffer::BeginFrame(void)
+{
+	m_frameUsed = 0;
+
+	GLsync fence = static_cast<GLsync>(m_fences[m_frameIndex]);
+
+	if (!fence)
+		return;
+
+	// Only blocks when the CPU is more than frameCount frames ahead of the GPU
+	GLenum result = glClientWaitSync(fence, 0, 0);
+
+	while (result == GL_TIMEOUT_EXPIRED)
+		result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, g_fenceTimeout);
+
+	if (result == GL_WAIT_FAILED)
+		std::printf("Failed to wait for ring buffer fence.\n");
+
+	glDeleteSync(fence);
+	m_fences[m_frameIndex] = nullptr;
+}
+
+void src::RingBuffer::EndFrame(void)
+{
+	if (m_fences[m_frameIndex])
+		glDeleteSync(static_cast<GLsync>(m_fences[m_frameIndex]));
+
+	m_fences[m_frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	m_frameIndex = (m_frameIndex + 1) % m_frameCount;
+}
+
+src::RingAllocation src::RingBuffer::Allocate(uint64_t size, uint64_t alignment)
+{
+	RingAllocation allocation;
+
+	if (!m_mappedData || size == 0)
+		return allocation;
+
+	if (alignment == 0)
+		alignment = 1;
+
+	const uint64_t regionStart = static_cast<uint64_t>(m_frameIndex) * m_frameSize;
+	const uint64_t offset = (regionStart + m_frameUsed + alignment - 1) / alignment * alignment;
+
+	if (offset + size > regionStart + m_frameSize)
+	{
+		std::printf("Failed to allocate %llu bytes from ring buffer, frame region is full.\n", static_cast<unsigned long long>(size));
+		return allocation;
+	}
+
+	m_frameUsed = offset + size - regionStart;
+
+	allocation.m_data = m_mappedData + offset;
+	allocation.m_buffer = m_buffer;
+	allocation.m_offset = offset;
+	allocation.m_size = size;
+
+	return allocation;
+}
+
+uint64_t src::RingBuffer::GetUniformAlignment(void) const noexcept
+{
+	return m_uniformAlignment;
+}
+
+unsigned int src::RingBuffer::GetBuffer(void) const noexcept
+{
+	return m_buffer;
+}
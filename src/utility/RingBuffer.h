@@ -0,0 +1,59 @@
+#pragma once
+
+#include "utility/Buffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace src
+{
+	struct RingAllocation
+	{
+		bool IsValid(void) const noexcept
+		{
+			return m_data != nullptr;
+		}
+
+		void*			m_data = nullptr;	// Write only, visible to the GPU without flushing
+		unsigned int	m_buffer = 0;
+		uint64_t		m_offset = 0;		// Bytes from the start of m_buffer, for glBindBufferRange etc.
+		uint64_t		m_size = 0;
+	};
+
+	/*
+	*	Persistently and coherently mapped buffer split in one region per frame in flight.
+	*	Each frame allocates linearly from its region, EndFrame fences the region and BeginFrame
+	*	waits on the fence of the region it is about to reuse, so writes never race the GPU and
+	*	uploads never go through glBufferSubData.
+	*/
+	class RingBuffer
+	{
+	public:
+		RingBuffer(void) = delete;
+		RingBuffer(uint64_t frameSize, unsigned int frameCount = 3);
+		RingBuffer(RingBuffer const&) = delete;
+		RingBuffer& operator=(RingBuffer const&) = delete;
+		~RingBuffer(void);
+
+		void BeginFrame(void);
+		void EndFrame(void);
+
+		// Invalid allocation once the frame's region is full
+		RingAllocation Allocate(uint64_t size, uint64_t alignment);
+
+		// Offset alignment required by glBindBufferRange(GL_UNIFORM_BUFFER, ...)
+		uint64_t		GetUniformAlignment(void) const noexcept;
+		unsigned int	GetBuffer(void) const noexcept;
+
+	private:
+		Buffer				m_buffer;
+		std::byte*			m_mappedData;
+		std::vector<void*>	m_fences; // GLsync per frame region
+		uint64_t			m_frameSize;
+		uint64_t			m_frameUsed;
+		uint64_t			m_uniformAlignment;
+		unsigned int		m_frameCount;
+		unsigned int		m_frameIndex;
+	};
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// Instruction sets available to the current translation unit, SSE2 is part of every x64 target
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define SRC_SIMD_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+// Only when the compiler targets it (/arch:AVX, -mavx), there is no runtime dispatch
+#if defined(SRC_SIMD_SSE2) && defined(__AVX__)
+	#define SRC_SIMD_AVX 1
+	#include <immintrin.h>
+#endif
@@ -0,0 +1,194 @@
+#include "utility/ThreadPool.h"
+
+#include <atomic>
+#include <exception>
+
+src::ThreadPool::ThreadPool(unsigned int threadCount)
+	: m_activeTasks(0), m_stop(false)
+{
+	// Default to one worker per hardware thread, leaving the calling thread free
+	if (threadCount == 0)
+	{
+		const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		threadCount = (hardwareThreads > 1) ? hardwareThreads - 1 : 1;
+	}
+
+	m_workers.reserve(threadCount);
+
+	for (unsigned int i = 0; i < threadCount; ++i)
+		m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+src::ThreadPool::~ThreadPool(void)
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_stop = true;
+	}
+
+	m_taskCondition.notify_all();
+
+	for (std::thread& worker : m_workers)
+		worker.join();
+}
+
+void src::ThreadPool::Submit(std::function<void(void)> task)
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_tasks.push_back(std::move(task));
+	}
+
+	m_taskCondition.notify_one();
+}
+
+void src::ThreadPool::ParallelFor(size_t count, size_t grainSize, std::function<void(size_t begin, size_t end)> const& func)
+{
+	if (count == 0)
+		return;
+
+	if (grainSize == 0)
+		grainSize = 1;
+
+	const size_t chunkCount = (count + grainSize - 1) / grainSize;
+
+	// Not worth waking the workers for a single chunk
+	if (chunkCount == 1)
+	{
+		func(0, count);
+		return;
+	}
+
+	std::atomic<size_t> nextChunk = 0;
+	std::exception_ptr exception; // First one thrown by 'func', guarded by m_mutex
+
+	// Stops handing out chunks once 'func' threw, on the calling thread or on a helper
+	auto processChunks = [&](void)
+	{
+		try
+		{
+			for (size_t chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1))
+			{
+				const size_t begin = chunk * grainSize;
+				const size_t end = (begin + grainSize < count) ? begin + grainSize : count;
+
+				func(begin, end);
+			}
+		}
+		catch (...)
+		{
+			nextChunk = chunkCount;
+
+			std::lock_guard lock(m_mutex);
+
+			if (!exception)
+				exception = std::current_exception();
+		}
+	};
+
+	// Helpers that start after all chunks are taken simply return
+	const size_t helperCount = (chunkCount - 1 < m_workers.size()) ? chunkCount - 1 : m_workers.size();
+	size_t helpersRemaining = helperCount; // Guarded by m_mutex
+
+	for (size_t i = 0; i < helperCount; ++i)
+	{
+		Submit([this, &processChunks, &helpersRemaining](void)
+		{
+			processChunks();
+
+			{
+				std::lock_guard lock(m_mutex);
+				--helpersRemaining;
+			}
+
+			m_idleCondition.notify_all();
+		});
+	}
+
+	processChunks();
+
+	// Run queued tasks while waiting: a caller that is itself a pool task may be waiting on helpers
+	// queued behind it, with every worker busy they would otherwise never start.
+	// Helpers reference this frame, so even a throwing borrowed task can't end the wait early
+	std::exception_ptr taskException; // First one thrown by a borrowed task
+	std::unique_lock lock(m_mutex);
+
+	while (helpersRemaining != 0)
+	{
+		if (m_tasks.empty())
+		{
+			m_idleCondition.wait(lock);
+			continue;
+		}
+
+		std::function<void(void)> task = std::move(m_tasks.front());
+		m_tasks.pop_front();
+		++m_activeTasks;
+
+		lock.unlock();
+
+		try
+		{
+			task();
+		}
+		catch (...)
+		{
+			if (!taskException)
+				taskException = std::current_exception();
+		}
+
+		lock.lock();
+
+		--m_activeTasks;
+		m_idleCondition.notify_all();
+	}
+
+	// Helpers are done, nothing else touches it anymore
+	lock.unlock();
+
+	if (exception)
+		std::rethrow_exception(exception);
+
+	if (taskException)
+		std::rethrow_exception(taskException);
+}
+
+void src::ThreadPool::Wait(void)
+{
+	std::unique_lock lock(m_mutex);
+	m_idleCondition.wait(lock, [this](void) { return m_tasks.empty() && m_activeTasks == 0; });
+}
+
+unsigned int src::ThreadPool::GetThreadCount(void) const noexcept
+{
+	return static_cast<unsigned int>(m_workers.size());
+}
+
+void src::ThreadPool::WorkerLoop(void)
+{
+	while (true)
+	{
+		std::function<void(void)> task;
+
+		{
+			std::unique_lock lock(m_mutex);
+			m_taskCondition.wait(lock, [this](void) { return m_stop || !m_tasks.empty(); });
+
+			if (m_stop && m_tasks.empty())
+				return;
+
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+			++m_activeTasks;
+		}
+
+		task();
+
+		{
+			std::lock_guard lock(m_mutex);
+			--m_activeTasks;
+		}
+
+		m_idleCondition.notify_all();
+	}
+}
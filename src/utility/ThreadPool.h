@@ -0,0 +1,48 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace src
+{
+	class ThreadPool
+	{
+	public:
+		ThreadPool(void) = delete;
+		ThreadPool(unsigned int threadCount); // 0 = one worker per hardware thread (minus the caller)
+		ThreadPool(ThreadPool const&) = delete;
+		ThreadPool& operator=(ThreadPool const&) = delete;
+		~ThreadPool(void);
+
+		// Queue a task to be executed by one of the worker threads
+		void Submit(std::function<void(void)> task);
+
+		// Split [0, count) into chunks of 'grainSize' and run them across the workers,
+		// the calling thread also processes chunks and only returns once every chunk is done.
+		// Safe to call from a pool task, the caller runs queued tasks while it waits. The first
+		// exception thrown by 'func' stops the loop and is rethrown once the helpers are done,
+		// one thrown by a queued task run while waiting is rethrown after it (if 'func' didn't throw).
+		void ParallelFor(size_t count, size_t grainSize, std::function<void(size_t begin, size_t end)> const& func);
+
+		// Block until every submitted task has finished
+		void Wait(void);
+
+		unsigned int GetThreadCount(void) const noexcept;
+
+	private:
+		void WorkerLoop(void);
+
+		std::vector<std::thread>				m_workers;
+		std::deque<std::function<void(void)>>	m_tasks;
+		std::mutex								m_mutex;
+		std::condition_variable					m_taskCondition;
+		std::condition_variable					m_idleCondition;
+		size_t									m_activeTasks;
+		bool									m_stop;
+	};
+}
@@ -5,11 +5,29 @@ layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec3 aTangent;
 layout (location = 3) in vec3 aBiTangent;
 layout (location = 4) in vec2 aTexCoord;
+layout (location = 5) in uint aChunkId; // Per instance, equals the draw command's baseInstance
+
+// Per chunk data (see TerrainRenderer.h)
+struct ChunkData
+{
+    vec4 boundsMin;
+    vec4 boundsMax;
+};
+
+layout (std430, binding = 1) readonly buffer Chunks
+{
+    ChunkData chunks[];
+};
 
 out vec2 uvs;
+flat out uint chunkId;
 
 void main()
 {
+   // Chunk mesh is local to the chunk origin
+   vec3 origin = vec3(chunks[aChunkId].boundsMin.x, 0.0, chunks[aChunkId].boundsMin.z);
+
    uvs = aTexCoord;
-   gl_Position = vec4(aPos, 1.0);  
+   chunkId = aChunkId;
+   gl_Position = vec4(aPos + origin, 1.0);  
 }
\ No newline at end of file